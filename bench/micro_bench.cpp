@@ -0,0 +1,206 @@
+// Microbenchmarks for the hot solver kernels, parameterized over board size.
+// Reports ns/op and, where perf_event_open is available, cache misses/op.
+//
+// Usage: micro_bench [filter]   (runs benchmarks whose name contains filter)
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_set>
+
+#include "common/sudoku_solver.hpp"
+
+namespace {
+
+// Keeps the compiler from discarding a benchmarked result.
+template <typename T>
+inline void do_not_optimize(const T& value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+class CacheMissCounter {
+ public:
+  CacheMissCounter() {
+    perf_event_attr attr{};
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+  }
+  ~CacheMissCounter() {
+    if (fd_ != -1) close(fd_);
+  }
+
+  bool available() const { return fd_ != -1; }
+
+  void start() {
+    if (fd_ == -1) return;
+    ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+    ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+  }
+
+  std::uint64_t stop() {
+    std::uint64_t count = 0;
+    if (fd_ == -1) return count;
+    ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+    if (read(fd_, &count, sizeof(count)) != sizeof(count)) count = 0;
+    return count;
+  }
+
+ private:
+  int fd_ = -1;
+};
+
+std::string filter;
+
+// Doubles the iteration count until a run takes at least 100 ms, then
+// reports the per-iteration cost of that run.
+template <typename Op>
+void run_benchmark(const std::string& name, int n, Op&& op) {
+  std::string full_name = "BM_" + name + "/" + std::to_string(n);
+  if (full_name.find(filter) == std::string::npos) return;
+
+  using Clock = std::chrono::steady_clock;
+  static CacheMissCounter counter;
+  std::size_t iterations = 1;
+  while (true) {
+    counter.start();
+    auto start = Clock::now();
+    for (std::size_t i = 0; i < iterations; ++i) op(i);
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start)
+                    .count();
+    std::uint64_t misses = counter.stop();
+
+    if (ns >= 1e8 || iterations >= (std::size_t{1} << 32)) {
+      printf("%-32s %12zu iters %12.1f ns/op", full_name.c_str(), iterations,
+             ns / iterations);
+      if (counter.available()) {
+        printf(" %10.3f misses/op", static_cast<double>(misses) / iterations);
+      }
+      printf("\n");
+      return;
+    }
+    iterations *= 2;
+  }
+}
+
+// Classic board with about half of a valid solution given as clues.
+template <int N>
+typename SudokuSolver<N, SolverType::Backtracking>::Board make_board() {
+  constexpr int block = N == 4 ? 2 : N == 9 ? 3 : N == 16 ? 4 : 5;
+  std::mt19937 rng(N);
+  typename SudokuSolver<N, SolverType::Backtracking>::Board board;
+  for (int r = 0; r < N; ++r) {
+    for (int c = 0; c < N; ++c) {
+      int value = (block * (r % block) + r / block + c) % N;
+      board[r][c] = Square{r * N + c, rng() % 2 ? value : -1};
+    }
+  }
+  return board;
+}
+
+// Expose the protected kernels of each solver.
+template <int N>
+struct BacktrackingProbe : BacktrackingSolver<N> {
+  using BacktrackingSolver<N>::adjMatrix;
+  using BacktrackingSolver<N>::count_remaining_values;
+  using BacktrackingSolver<N>::find_mrv_position;
+  using BacktrackingSolver<N>::is_safe;
+};
+
+template <int N>
+struct KempeProbe : HeuristicKempeSolver<N> {
+  using HeuristicKempeSolver<N>::adjMatrix;
+  using HeuristicKempeSolver<N>::find_vertex_with_degree_less_than_k;
+  using HeuristicKempeSolver<N>::is_valid_color;
+};
+
+template <int N>
+struct DSaturProbe : DSaturSolver<N> {
+  using DSaturSolver<N>::select_vertex;
+};
+
+template <int N>
+void bench_size() {
+  constexpr int SIZE = N * N;
+  using Solver = SudokuSolver<N, SolverType::Backtracking>;
+
+  auto sudoku = std::make_unique<Solver>(make_board<N>());
+  run_benchmark("graph_construction", N, [&](std::size_t) {
+    sudoku->create_region_deps();
+    sudoku->normalize_adj_matrix();
+    do_not_optimize(sudoku->adjMatrix);
+  });
+  const auto& adj = sudoku->adjMatrix;
+
+  std::array<int, SIZE> values;
+  for (int i = 0; i < SIZE; ++i) values[i] = sudoku->board[i / N][i % N].value;
+
+  auto backtracking = std::make_unique<BacktrackingProbe<N>>();
+  backtracking->adjMatrix = &adj;
+  run_benchmark("count_remaining_values", N, [&](std::size_t i) {
+    do_not_optimize(backtracking->count_remaining_values(values, i % SIZE));
+  });
+  run_benchmark("is_safe", N, [&](std::size_t i) {
+    do_not_optimize(backtracking->is_safe(values, i % SIZE, i % N));
+  });
+  run_benchmark("mrv_selection", N, [&](std::size_t) {
+    do_not_optimize(backtracking->find_mrv_position(values));
+  });
+
+  auto kempe = std::make_unique<KempeProbe<N>>();
+  kempe->adjMatrix = &adj;
+  run_benchmark("is_valid_color", N, [&](std::size_t i) {
+    do_not_optimize(kempe->is_valid_color(values, i % SIZE, i % N));
+  });
+  run_benchmark("kempe_selection", N, [&](std::size_t) {
+    do_not_optimize(kempe->find_vertex_with_degree_less_than_k(values));
+  });
+
+  auto neighbor_colors =
+      std::make_unique<std::array<std::unordered_set<int>, SIZE>>();
+  std::array<int, SIZE> degrees{};
+  std::array<bool, SIZE> colored{};
+  for (int i = 0; i < SIZE; ++i) {
+    colored[i] = values[i] != -1;
+    for (int j = 0; j < SIZE; ++j) {
+      if (!adj[i][j]) continue;
+      degrees[i]++;
+      if (values[j] != -1) (*neighbor_colors)[i].insert(values[j]);
+    }
+  }
+  auto dsatur = std::make_unique<DSaturProbe<N>>();
+  run_benchmark("dsatur_selection", N, [&](std::size_t) {
+    do_not_optimize(dsatur->select_vertex(*neighbor_colors, degrees, colored));
+  });
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  if (argc > 1) filter = argv[1];
+
+  if (!CacheMissCounter().available()) {
+    printf("perf_event_open unavailable: %s; reporting ns/op only\n",
+           strerror(errno));
+  }
+
+  bench_size<4>();
+  bench_size<9>();
+  bench_size<16>();
+  bench_size<25>();
+  return 0;
+}
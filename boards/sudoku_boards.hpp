@@ -5,6 +5,8 @@
 
 namespace SudokuBoards {
 
+// Values are colors 0..N-1 (-1 is empty); color 0 is printed as the digit N.
+
 // 4x4 Sudoku board
 constexpr std::array<std::array<Square, 4>, 4> BOARD_4x4{
     std::array<Square, 4>{Square{0, 0}, Square{1, 1}, Square{2, -1},
@@ -61,7 +63,7 @@ constexpr std::array<std::array<Square, 9>, 9> BOARD_9x9_EXTREME{
                           Square{24, -1}, Square{25, 4}, Square{26, -1}},
     std::array<Square, 9>{Square{27, 2}, Square{28, -1}, Square{29, -1},
                           Square{30, 8}, Square{31, -1}, Square{32, -1},
-                          Square{33, -1}, Square{34, 9}, Square{35, -1}},
+                          Square{33, -1}, Square{34, 0}, Square{35, -1}},
     std::array<Square, 9>{Square{36, -1}, Square{37, -1}, Square{38, -1},
                           Square{39, -1}, Square{40, -1}, Square{41, -1},
                           Square{42, -1}, Square{43, -1}, Square{44, -1}},
@@ -71,12 +73,12 @@ constexpr std::array<std::array<Square, 9>, 9> BOARD_9x9_EXTREME{
     std::array<Square, 9>{Square{54, -1}, Square{55, -1}, Square{56, 6},
                           Square{57, 3}, Square{58, -1}, Square{59, -1},
                           Square{60, -1}, Square{61, -1}, Square{62, -1}},
-    std::array<Square, 9>{Square{63, -1}, Square{64, -1}, Square{65, 9},
+    std::array<Square, 9>{Square{63, -1}, Square{64, -1}, Square{65, 0},
                           Square{66, 2}, Square{67, -1}, Square{68, -1},
                           Square{69, -1}, Square{70, 1}, Square{71, -1}},
     std::array<Square, 9>{Square{72, -1}, Square{73, -1}, Square{74, 7},
                           Square{75, -1}, Square{76, 8}, Square{77, -1},
-                          Square{78, -1}, Square{79, 6}, Square{80, 9}}
+                          Square{78, -1}, Square{79, 6}, Square{80, 0}}
 };
 
 } // namespace SudokuBoards 
\ No newline at end of file
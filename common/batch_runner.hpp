@@ -0,0 +1,339 @@
+#pragma once
+
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <new>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "budget.hpp"
+#include "puzzle_io.hpp"
+
+// Multi-process batch solving of a puzzle file. The file is split into
+// line-aligned byte ranges, one forked worker per range. Each worker writes
+// its results into its own shared-memory ring, and the coordinator drains the
+// rings shard by shard, so the output keeps the input order. A worker that
+// dies is restarted from the last line it published. A line that keeps
+// killing workers is skipped and reported as crashed.
+
+enum class PinMode {
+    None,
+    Core,  // One CPU per worker, round robin over the allowed CPUs
+    Numa   // All CPUs of one NUMA node per worker, round robin over nodes
+};
+
+struct BatchOptions {
+    int workers = 1;
+    PinMode pin = PinMode::Core;
+    int max_retries = 2;  // Restarts at the same line before it is skipped
+};
+
+struct BatchResult {
+    SolveStatus status;
+    std::string text;  // Output line for the board
+};
+
+// Runs inside a worker process for every board line
+using LineSolver = std::function<BatchResult(std::string_view line)>;
+
+struct BatchSummary {
+    std::size_t boards = 0;
+    std::array<std::size_t, SOLVE_STATUS_COUNT> by_status{};  // Indexed by SolveStatus
+    std::size_t crashed = 0;                 // Lines skipped after worker deaths
+    std::size_t restarts = 0;
+};
+
+namespace batch_detail {
+
+constexpr std::size_t RING_CAPACITY = 64;
+constexpr std::size_t MAX_LINE = 1024;
+
+enum class RecordKind : std::uint32_t {
+    Board,
+    Passthrough,  // Blank or comment line, copied to the output
+    Crashed,
+    End
+};
+
+struct Record {
+    std::uint64_t next_offset;  // Byte offset just past this line
+    RecordKind kind;
+    SolveStatus status;
+    std::uint32_t length;
+    char text[MAX_LINE];
+};
+
+// Single-producer single-consumer queue in shared memory; a restarted worker
+// becomes the producer once the previous one is dead.
+struct Ring {
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+                  "ring counters must be address-free to work across processes");
+
+    std::atomic<std::uint64_t> head{0};  // Next record to consume
+    std::atomic<std::uint64_t> tail{0};  // Next record to publish
+    Record records[RING_CAPACITY];
+};
+
+inline void publish(Ring& ring, RecordKind kind, SolveStatus status, std::string_view text,
+                    std::uint64_t next_offset) {
+    std::uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+    while (tail - ring.head.load(std::memory_order_acquire) >= RING_CAPACITY) {
+        usleep(50);
+    }
+    Record& record = ring.records[tail % RING_CAPACITY];
+    record.next_offset = next_offset;
+    record.kind = kind;
+    record.status = status;
+    record.length = static_cast<std::uint32_t>(std::min(text.size(), MAX_LINE));
+    if (record.length > 0) {
+        std::memcpy(record.text, text.data(), record.length);  // End has no text
+    }
+    // Publishing is this single store, so a dead worker leaves either the
+    // whole record or none of it
+    ring.tail.store(tail + 1, std::memory_order_release);
+}
+
+[[noreturn]] inline void run_worker(const std::string& path, std::uint64_t begin,
+                                    std::uint64_t end, bool skip_first, Ring& ring,
+                                    const LineSolver& solve) {
+    std::ifstream in(path, std::ios::binary);
+    in.seekg(static_cast<std::streamoff>(begin));
+    std::uint64_t offset = begin;
+    std::string line;
+    while (offset < end && std::getline(in, line)) {
+        std::uint64_t next = offset + line.size() + 1;
+        if (skip_first) {
+            publish(ring, RecordKind::Crashed, SolveStatus::Unsolvable, line, next);
+            skip_first = false;
+        } else if (!is_board_line(line)) {
+            publish(ring, RecordKind::Passthrough, SolveStatus::Unsolvable, line, next);
+        } else {
+            BatchResult result = solve(line);
+            publish(ring, RecordKind::Board, result.status, result.text, next);
+        }
+        offset = next;
+    }
+    publish(ring, RecordKind::End, SolveStatus::Unsolvable, {}, offset);
+    _exit(0);
+}
+
+// Parses a sysfs CPU list such as "0-3,8-11"
+inline std::vector<int> parse_cpu_list(const std::string& list) {
+    std::vector<int> cpus;
+    std::size_t pos = 0;
+    while (pos < list.size()) {
+        std::size_t comma = list.find(',', pos);
+        std::string range = list.substr(pos, comma == std::string::npos ? std::string::npos
+                                                                          : comma - pos);
+        std::size_t dash = range.find('-');
+        int first = std::stoi(range.substr(0, dash));
+        int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+        for (int cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+        if (comma == std::string::npos) {
+            break;
+        }
+        pos = comma + 1;
+    }
+    return cpus;
+}
+
+// CPU sets the workers are pinned to, used round robin; empty means no pinning
+inline std::vector<cpu_set_t> pin_targets(PinMode mode) {
+    std::vector<cpu_set_t> targets;
+    cpu_set_t allowed;
+    if (mode == PinMode::None || sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        return targets;
+    }
+
+    if (mode == PinMode::Numa) {
+        for (int node = 0;; ++node) {
+            std::ifstream list("/sys/devices/system/node/node" + std::to_string(node) +
+                               "/cpulist");
+            std::string cpus;
+            if (!std::getline(list, cpus)) {
+                break;
+            }
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            for (int cpu : parse_cpu_list(cpus)) {
+                if (CPU_ISSET(cpu, &allowed)) {
+                    CPU_SET(cpu, &set);
+                }
+            }
+            if (CPU_COUNT(&set) > 0) {
+                targets.push_back(set);
+            }
+        }
+        if (!targets.empty()) {
+            return targets;
+        }
+        // No NUMA information: fall back to one core per worker
+    }
+
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &allowed)) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu, &set);
+            targets.push_back(set);
+        }
+    }
+    return targets;
+}
+
+// Line-aligned shard boundaries: shard i covers [bounds[i], bounds[i + 1])
+inline std::vector<std::uint64_t> shard_bounds(const std::string& path, int shards) {
+    std::uint64_t size = std::filesystem::file_size(path);
+    std::vector<std::uint64_t> bounds{0};
+    std::ifstream in(path, std::ios::binary);
+    for (int i = 1; i < shards; ++i) {
+        std::uint64_t pos = std::max(size * i / shards, bounds.back());
+        if (pos > 0 && pos < size) {
+            // Move past the end of the line containing pos - 1
+            in.clear();
+            in.seekg(static_cast<std::streamoff>(pos - 1));
+            std::string rest;
+            std::getline(in, rest);
+            pos = std::min(size, pos - 1 + rest.size() + 1);
+        }
+        bounds.push_back(pos);
+    }
+    bounds.push_back(size);
+    return bounds;
+}
+
+}  // namespace batch_detail
+
+inline BatchSummary run_batch(const std::string& path, std::ostream& out,
+                              const LineSolver& solve, const BatchOptions& options) {
+    using namespace batch_detail;
+
+    int shards = std::max(options.workers, 1);
+    std::vector<std::uint64_t> bounds = shard_bounds(path, shards);
+    std::vector<cpu_set_t> targets = pin_targets(options.pin);
+
+    std::size_t bytes = sizeof(Ring) * shards;
+    void* memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        throw std::runtime_error("Cannot map result rings");
+    }
+    Ring* rings = static_cast<Ring*>(memory);
+    for (int i = 0; i < shards; ++i) {
+        new (&rings[i]) Ring();
+    }
+
+    struct Shard {
+        pid_t pid = -1;
+        std::uint64_t consumed_offset = 0;  // Just past the last drained record
+        bool drained = false;               // End record consumed
+        std::uint64_t crash_offset = 0;     // Line the last death happened on
+        int deaths = 0;                  // Deaths in a row on that line
+    };
+    std::vector<Shard> workers(shards);
+    BatchSummary summary;
+
+    auto spawn = [&](int i, std::uint64_t begin, bool skip_first) {
+        out.flush();  // Don't duplicate buffered output into the child
+        pid_t pid = fork();
+        if (pid == -1) {
+            throw std::runtime_error("fork failed");
+        }
+        if (pid == 0) {
+            if (!targets.empty()) {
+                sched_setaffinity(0, sizeof(cpu_set_t), &targets[i % targets.size()]);
+            }
+            run_worker(path, begin, bounds[i + 1], skip_first, rings[i], solve);
+        }
+        workers[i].pid = pid;
+    };
+
+    // Restarts every shard whose worker died before finishing its range
+    auto reap = [&] {
+        for (int i = 0; i < shards; ++i) {
+            Shard& shard = workers[i];
+            int status;
+            if (shard.pid == -1 || waitpid(shard.pid, &status, WNOHANG) != shard.pid) {
+                continue;
+            }
+            shard.pid = -1;
+            // Resume after the last record the dead worker made visible,
+            // unless that was its End record
+            Ring& ring = rings[i];
+            std::uint64_t head = ring.head.load(std::memory_order_relaxed);
+            std::uint64_t tail = ring.tail.load(std::memory_order_acquire);
+            if (shard.drained ||
+                (tail > head && ring.records[(tail - 1) % RING_CAPACITY].kind == RecordKind::End)) {
+                continue;
+            }
+            std::uint64_t resume = tail > head
+                                       ? ring.records[(tail - 1) % RING_CAPACITY].next_offset
+                                       : shard.consumed_offset;
+            shard.deaths = resume == shard.crash_offset ? shard.deaths + 1 : 1;
+            shard.crash_offset = resume;
+            summary.restarts++;
+            spawn(i, resume, shard.deaths > options.max_retries);
+        }
+    };
+
+    for (int i = 0; i < shards; ++i) {
+        workers[i].consumed_offset = bounds[i];
+        workers[i].crash_offset = bounds[i];
+        spawn(i, bounds[i], false);
+    }
+
+    for (int i = 0; i < shards; ++i) {
+        Ring& ring = rings[i];
+        while (!workers[i].drained) {
+            std::uint64_t head = ring.head.load(std::memory_order_relaxed);
+            if (head == ring.tail.load(std::memory_order_acquire)) {
+                reap();
+                usleep(50);
+                continue;
+            }
+            const Record& record = ring.records[head % RING_CAPACITY];
+            switch (record.kind) {
+                case RecordKind::Board:
+                    summary.boards++;
+                    summary.by_status[static_cast<int>(record.status)]++;
+                    out.write(record.text, record.length) << '\n';
+                    break;
+                case RecordKind::Passthrough:
+                    out.write(record.text, record.length) << '\n';
+                    break;
+                case RecordKind::Crashed:
+                    summary.boards++;
+                    summary.crashed++;
+                    out.write(record.text, record.length) << '\n';
+                    break;
+                case RecordKind::End:
+                    workers[i].drained = true;
+                    break;
+            }
+            workers[i].consumed_offset = record.next_offset;
+            ring.head.store(head + 1, std::memory_order_release);
+        }
+    }
+
+    for (const Shard& shard : workers) {
+        if (shard.pid != -1) {
+            waitpid(shard.pid, nullptr, 0);
+        }
+    }
+    munmap(memory, bytes);
+    return summary;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+enum class SolveStatus {
+    Solved,
+    Unsolvable,      // A complete search ran out of options: no solution exists
+    Failed,          // A heuristic gave up; says nothing about solvability
+    BudgetExceeded,  // The board holds the deepest partial assignment found
+    Cancelled        // Stopped through the stop token, e.g. by the portfolio
+};
+
+inline constexpr std::size_t SOLVE_STATUS_COUNT = 5;
+
+inline const char* to_string(SolveStatus status) {
+    switch (status) {
+        case SolveStatus::Solved:
+            return "solved";
+        case SolveStatus::Unsolvable:
+            return "unsolvable";
+        case SolveStatus::Failed:
+            return "failed";
+        case SolveStatus::BudgetExceeded:
+            return "budget exceeded";
+        case SolveStatus::Cancelled:
+            return "cancelled";
+    }
+    return "unknown";
+}
+
+// Per-solve limits; zero means unlimited.
+struct SolveBudget {
+    std::chrono::milliseconds time{0};
+    std::size_t nodes = 0;         // Compared against the solver's step count
+    std::size_t memory_bytes = 0;  // Resident set size of the whole process
+};
+
+// Resident set size in bytes, or 0 where it cannot be read.
+inline std::size_t resident_memory() {
+#if defined(__linux__)
+    std::ifstream statm("/proc/self/statm");
+    std::size_t pages = 0, resident = 0;
+    if (statm >> pages >> resident) {
+        return resident * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    }
+#endif
+    return 0;
+}
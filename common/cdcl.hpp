@@ -0,0 +1,490 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "luby.hpp"
+
+// Compact CDCL SAT engine: two watched literals, VSIDS branching, first-UIP
+// clause learning, phase saving, Luby restarts and activity-based deletion
+// of learnt clauses.
+namespace cdcl {
+
+// Variable v has the literals 2v (positive) and 2v + 1 (negative)
+using Lit = int;
+
+inline Lit make_lit(int var, bool negative = false) { return 2 * var + (negative ? 1 : 0); }
+inline Lit negate(Lit lit) { return lit ^ 1; }
+inline int var_of(Lit lit) { return lit >> 1; }
+inline bool is_negative(Lit lit) { return lit & 1; }
+
+enum class Result {
+    Sat,
+    Unsat,
+    Unknown  // Stopped before an answer was found
+};
+
+class Solver {
+public:
+    int new_var() {
+        int var = num_vars++;
+        assigns.push_back(UNDEF);
+        level.push_back(0);
+        reason.push_back(NO_REASON);
+        activity.push_back(0.0);
+        polarity.push_back(1);
+        seen.push_back(0);
+        heap_index.push_back(-1);
+        watches.emplace_back();
+        watches.emplace_back();
+        heap_insert(var);
+        return var;
+    }
+
+    // Adds a clause before solving. Returns false once the formula is known
+    // to be unsatisfiable.
+    bool add_clause(std::vector<Lit> lits) {
+        if (!ok) {
+            return false;
+        }
+        std::sort(lits.begin(), lits.end());
+        std::size_t j = 0;
+        for (std::size_t i = 0; i < lits.size(); ++i) {
+            int value = lit_value(lits[i]);
+            if (value == TRUE || (j > 0 && lits[i] == negate(lits[j - 1]))) {
+                return true;  // Satisfied or tautology
+            }
+            if (value != FALSE && (j == 0 || lits[i] != lits[j - 1])) {
+                lits[j++] = lits[i];
+            }
+        }
+        lits.resize(j);
+
+        if (lits.empty()) {
+            ok = false;
+        } else if (lits.size() == 1) {
+            enqueue(lits[0], NO_REASON);
+            ok = propagate() == NO_REASON;
+        } else {
+            attach(new_clause(std::move(lits), false));
+        }
+        return ok;
+    }
+
+    // should_stop() is polled before every decision; returning true ends the
+    // search with Result::Unknown.
+    template <typename StopFn>
+    Result solve(StopFn&& should_stop) {
+        if (!ok) {
+            return Result::Unsat;
+        }
+        max_learnts = std::max<std::size_t>(clauses.size() / 3, 1000);
+        for (std::size_t run = 1;; ++run) {
+            Result result = search(RESTART_BASE * luby(run), should_stop);
+            if (result != Result::Unknown || stopped) {
+                return result;
+            }
+        }
+    }
+
+    // Value of a variable in the satisfying assignment found by solve()
+    bool model_value(int var) const { return model[var]; }
+
+    // Value forced at decision level 0 (1 true, -1 false, 0 open); after an
+    // interrupted solve this is everything the search proved.
+    int fixed_value(int var) const { return assigns[var]; }
+
+    int get_num_vars() const { return num_vars; }
+    std::size_t get_decisions() const { return decisions; }
+    std::size_t get_conflicts() const { return conflicts; }
+
+private:
+    static constexpr std::int8_t TRUE = 1;
+    static constexpr std::int8_t FALSE = -1;
+    static constexpr std::int8_t UNDEF = 0;
+    static constexpr int NO_REASON = -1;
+    static constexpr std::size_t RESTART_BASE = 100;
+    static constexpr double VAR_DECAY = 0.95;
+    static constexpr double CLAUSE_DECAY = 0.999;
+
+    struct Clause {
+        std::vector<Lit> lits;
+        double activity;
+        bool learnt;
+        bool deleted;
+    };
+
+    struct Watcher {
+        int cref;
+        Lit blocker;  // Some other literal of the clause; skips the visit if true
+    };
+
+    bool ok = true;
+    bool stopped = false;
+    int num_vars = 0;
+    std::vector<Clause> clauses;
+    std::vector<std::vector<Watcher>> watches;  // Indexed by literal
+    std::size_t num_learnts = 0;
+    std::size_t max_learnts = 0;
+
+    std::vector<std::int8_t> assigns;
+    std::vector<int> level;
+    std::vector<int> reason;
+    std::vector<Lit> trail;
+    std::vector<std::size_t> trail_lim;
+    std::size_t qhead = 0;
+
+    std::vector<double> activity;
+    double var_inc = 1.0;
+    double clause_inc = 1.0;
+    std::vector<std::int8_t> polarity;  // Saved phase, 1 means negative
+    std::vector<std::int8_t> seen;
+    std::vector<int> heap;
+    std::vector<int> heap_index;
+
+    std::vector<bool> model;
+    std::size_t decisions = 0;
+    std::size_t conflicts = 0;
+
+    int decision_level() const { return static_cast<int>(trail_lim.size()); }
+
+    int lit_value(Lit lit) const {
+        int value = assigns[var_of(lit)];
+        return is_negative(lit) ? -value : value;
+    }
+
+    int new_clause(std::vector<Lit> lits, bool learnt) {
+        clauses.push_back(Clause{std::move(lits), 0.0, learnt, false});
+        if (learnt) {
+            num_learnts++;
+        }
+        return static_cast<int>(clauses.size()) - 1;
+    }
+
+    void attach(int cref) {
+        const auto& lits = clauses[cref].lits;
+        watches[lits[0]].push_back({cref, lits[1]});
+        watches[lits[1]].push_back({cref, lits[0]});
+    }
+
+    void enqueue(Lit lit, int from) {
+        int var = var_of(lit);
+        assigns[var] = is_negative(lit) ? FALSE : TRUE;
+        level[var] = decision_level();
+        reason[var] = from;
+        trail.push_back(lit);
+    }
+
+    // Returns the conflicting clause, or NO_REASON
+    int propagate() {
+        int conflict = NO_REASON;
+        while (qhead < trail.size() && conflict == NO_REASON) {
+            Lit false_lit = negate(trail[qhead++]);
+            auto& ws = watches[false_lit];
+            std::size_t i = 0, j = 0;
+            while (i < ws.size()) {
+                Watcher w = ws[i++];
+                if (lit_value(w.blocker) == TRUE) {
+                    ws[j++] = w;
+                    continue;
+                }
+                Clause& clause = clauses[w.cref];
+                if (clause.deleted) {
+                    continue;  // Drop watchers of deleted clauses lazily
+                }
+                auto& lits = clause.lits;
+                if (lits[0] == false_lit) {
+                    std::swap(lits[0], lits[1]);
+                }
+                Lit first = lits[0];
+                if (first != w.blocker && lit_value(first) == TRUE) {
+                    ws[j++] = {w.cref, first};
+                    continue;
+                }
+
+                bool moved = false;
+                for (std::size_t k = 2; k < lits.size(); ++k) {
+                    if (lit_value(lits[k]) != FALSE) {
+                        std::swap(lits[1], lits[k]);
+                        watches[lits[1]].push_back({w.cref, first});
+                        moved = true;
+                        break;
+                    }
+                }
+                if (moved) {
+                    continue;
+                }
+
+                ws[j++] = {w.cref, first};
+                if (lit_value(first) == FALSE) {
+                    conflict = w.cref;
+                    while (i < ws.size()) {
+                        ws[j++] = ws[i++];
+                    }
+                } else {
+                    enqueue(first, w.cref);
+                }
+            }
+            ws.resize(j);
+        }
+        return conflict;
+    }
+
+    // First-UIP learning; the asserting literal ends up at learnt[0]
+    void analyze(int conflict, std::vector<Lit>& learnt, int& backtrack_level) {
+        learnt.assign(1, 0);
+        int path = 0;
+        Lit p = -1;
+        std::size_t index = trail.size();
+
+        do {
+            Clause& clause = clauses[conflict];
+            if (clause.learnt) {
+                bump_clause(clause);
+            }
+            for (std::size_t k = (p == -1 ? 0 : 1); k < clause.lits.size(); ++k) {
+                Lit q = clause.lits[k];
+                int var = var_of(q);
+                if (!seen[var] && level[var] > 0) {
+                    seen[var] = 1;
+                    bump_var(var);
+                    if (level[var] >= decision_level()) {
+                        path++;
+                    } else {
+                        learnt.push_back(q);
+                    }
+                }
+            }
+            while (!seen[var_of(trail[--index])]) {
+            }
+            p = trail[index];
+            conflict = reason[var_of(p)];
+            seen[var_of(p)] = 0;
+            path--;
+        } while (path > 0);
+        learnt[0] = negate(p);
+
+        // Drop literals implied by the rest of the clause
+        std::vector<Lit> analyzed(learnt.begin() + 1, learnt.end());
+        std::size_t j = 1;
+        for (std::size_t i = 1; i < learnt.size(); ++i) {
+            int from = reason[var_of(learnt[i])];
+            bool redundant = from != NO_REASON;
+            if (redundant) {
+                const auto& lits = clauses[from].lits;
+                for (std::size_t k = 1; k < lits.size(); ++k) {
+                    int var = var_of(lits[k]);
+                    if (!seen[var] && level[var] > 0) {
+                        redundant = false;
+                        break;
+                    }
+                }
+            }
+            if (!redundant) {
+                learnt[j++] = learnt[i];
+            }
+        }
+        learnt.resize(j);
+        for (Lit lit : analyzed) {
+            seen[var_of(lit)] = 0;
+        }
+
+        backtrack_level = 0;
+        if (learnt.size() > 1) {
+            std::size_t max_i = 1;
+            for (std::size_t i = 2; i < learnt.size(); ++i) {
+                if (level[var_of(learnt[i])] > level[var_of(learnt[max_i])]) {
+                    max_i = i;
+                }
+            }
+            std::swap(learnt[1], learnt[max_i]);
+            backtrack_level = level[var_of(learnt[1])];
+        }
+    }
+
+    void cancel_until(int target) {
+        if (decision_level() <= target) {
+            return;
+        }
+        for (std::size_t i = trail.size(); i-- > trail_lim[target];) {
+            int var = var_of(trail[i]);
+            assigns[var] = UNDEF;
+            reason[var] = NO_REASON;
+            polarity[var] = is_negative(trail[i]);
+            if (heap_index[var] == -1) {
+                heap_insert(var);
+            }
+        }
+        trail.resize(trail_lim[target]);
+        trail_lim.resize(target);
+        qhead = trail.size();
+    }
+
+    template <typename StopFn>
+    Result search(std::size_t conflict_budget, StopFn& should_stop) {
+        std::size_t run_conflicts = 0;
+        std::vector<Lit> learnt;
+
+        while (true) {
+            int conflict = propagate();
+            if (conflict != NO_REASON) {
+                conflicts++;
+                run_conflicts++;
+                if (decision_level() == 0) {
+                    ok = false;
+                    return Result::Unsat;
+                }
+                int backtrack_level;
+                analyze(conflict, learnt, backtrack_level);
+                cancel_until(backtrack_level);
+                if (learnt.size() == 1) {
+                    enqueue(learnt[0], NO_REASON);
+                } else {
+                    int cref = new_clause(learnt, true);
+                    attach(cref);
+                    bump_clause(clauses[cref]);
+                    enqueue(learnt[0], cref);
+                }
+                var_inc /= VAR_DECAY;
+                clause_inc /= CLAUSE_DECAY;
+                continue;
+            }
+
+            if (run_conflicts >= conflict_budget || (stopped = should_stop())) {
+                cancel_until(0);
+                return Result::Unknown;
+            }
+            if (num_learnts >= max_learnts + trail.size()) {
+                reduce_db();
+            }
+
+            int next = pick_branch_var();
+            if (next == -1) {
+                model.assign(num_vars, false);
+                for (int var = 0; var < num_vars; ++var) {
+                    model[var] = assigns[var] == TRUE;
+                }
+                cancel_until(0);
+                return Result::Sat;
+            }
+            decisions++;
+            trail_lim.push_back(trail.size());
+            enqueue(make_lit(next, polarity[next]), NO_REASON);
+        }
+    }
+
+    int pick_branch_var() {
+        while (!heap.empty()) {
+            int var = heap_pop();
+            if (assigns[var] == UNDEF) {
+                return var;
+            }
+        }
+        return -1;
+    }
+
+    bool locked(int cref) const {
+        Lit first = clauses[cref].lits[0];
+        return reason[var_of(first)] == cref && lit_value(first) == TRUE;
+    }
+
+    // Deletes the less active half of the learnt clauses
+    void reduce_db() {
+        std::vector<int> learnts;
+        for (int cref = 0; cref < static_cast<int>(clauses.size()); ++cref) {
+            const Clause& clause = clauses[cref];
+            if (clause.learnt && !clause.deleted && clause.lits.size() > 2 && !locked(cref)) {
+                learnts.push_back(cref);
+            }
+        }
+        std::sort(learnts.begin(), learnts.end(), [this](int a, int b) {
+            return clauses[a].activity < clauses[b].activity;
+        });
+        for (std::size_t i = 0; i < learnts.size() / 2; ++i) {
+            Clause& clause = clauses[learnts[i]];
+            clause.deleted = true;
+            std::vector<Lit>().swap(clause.lits);
+            num_learnts--;
+        }
+        max_learnts += max_learnts / 10;
+    }
+
+    void bump_var(int var) {
+        activity[var] += var_inc;
+        if (activity[var] > 1e100) {
+            for (double& a : activity) {
+                a *= 1e-100;
+            }
+            var_inc *= 1e-100;
+        }
+        if (heap_index[var] != -1) {
+            sift_up(heap_index[var]);
+        }
+    }
+
+    void bump_clause(Clause& clause) {
+        clause.activity += clause_inc;
+        if (clause.activity > 1e20) {
+            for (Clause& c : clauses) {
+                c.activity *= 1e-20;
+            }
+            clause_inc *= 1e-20;
+        }
+    }
+
+    // Binary max-heap of variables ordered by activity
+    void heap_insert(int var) {
+        heap_index[var] = static_cast<int>(heap.size());
+        heap.push_back(var);
+        sift_up(heap_index[var]);
+    }
+
+    int heap_pop() {
+        int top = heap[0];
+        heap[0] = heap.back();
+        heap_index[heap[0]] = 0;
+        heap.pop_back();
+        heap_index[top] = -1;
+        if (!heap.empty()) {
+            sift_down(0);
+        }
+        return top;
+    }
+
+    void sift_up(int i) {
+        int var = heap[i];
+        while (i > 0) {
+            int parent = (i - 1) / 2;
+            if (activity[heap[parent]] >= activity[var]) {
+                break;
+            }
+            heap[i] = heap[parent];
+            heap_index[heap[i]] = i;
+            i = parent;
+        }
+        heap[i] = var;
+        heap_index[var] = i;
+    }
+
+    void sift_down(int i) {
+        int var = heap[i];
+        int size = static_cast<int>(heap.size());
+        while (2 * i + 1 < size) {
+            int child = 2 * i + 1;
+            if (child + 1 < size && activity[heap[child + 1]] > activity[heap[child]]) {
+                child++;
+            }
+            if (activity[heap[child]] <= activity[var]) {
+                break;
+            }
+            heap[i] = heap[child];
+            heap_index[heap[i]] = i;
+            i = child;
+        }
+        heap[i] = var;
+        heap_index[var] = i;
+    }
+};
+
+}  // namespace cdcl
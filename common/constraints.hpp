@@ -0,0 +1,129 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Killer-style cage: the cells hold distinct digits that add up to `sum`.
+struct Cage {
+    std::vector<int> cells;
+    int sum;
+};
+
+// Colors are 0..N-1 and printed as digits, with color 0 standing for N.
+template <int N>
+constexpr int color_to_digit(int color) {
+    return color == 0 ? N : color;
+}
+
+// Describes a Sudoku variant as a list of all-different regions plus cages.
+// The regions are compiled into the coloring graph by SudokuSolver, so any
+// variant runs through the same solvers as the classic puzzle.
+template <int N>
+class Constraints {
+public:
+    static constexpr int SIZE = N * N;
+    using Region = std::vector<int>;
+
+    static Constraints classic() {
+        Constraints constraints;
+        constraints.add_rows().add_cols().add_blocks();
+        return constraints;
+    }
+
+    Constraints &add_region(Region cells) {
+        for (int cell : cells) {
+            if (cell < 0 || cell >= SIZE) {
+                throw std::out_of_range("Region cell out of range");
+            }
+        }
+        regions_.push_back(std::move(cells));
+        return *this;
+    }
+
+    Constraints &add_rows() {
+        for (int row = 0; row < N; ++row) {
+            Region cells;
+            for (int col = 0; col < N; ++col) {
+                cells.push_back(row * N + col);
+            }
+            add_region(std::move(cells));
+        }
+        return *this;
+    }
+
+    Constraints &add_cols() {
+        for (int col = 0; col < N; ++col) {
+            Region cells;
+            for (int row = 0; row < N; ++row) {
+                cells.push_back(row * N + col);
+            }
+            add_region(std::move(cells));
+        }
+        return *this;
+    }
+
+    Constraints &add_blocks() {
+        int block_size = static_cast<int>(std::sqrt(N));
+        for (int block = 0; block < N; ++block) {
+            int block_row = (block / block_size) * block_size;
+            int block_col = (block % block_size) * block_size;
+            Region cells;
+            for (int dr = 0; dr < block_size; ++dr) {
+                for (int dc = 0; dc < block_size; ++dc) {
+                    cells.push_back((block_row + dr) * N + block_col + dc);
+                }
+            }
+            add_region(std::move(cells));
+        }
+        return *this;
+    }
+
+    // X-Sudoku: both main diagonals must hold distinct values.
+    Constraints &add_diagonals() {
+        Region main_diag, anti_diag;
+        for (int i = 0; i < N; ++i) {
+            main_diag.push_back(i * N + i);
+            anti_diag.push_back(i * N + (N - 1 - i));
+        }
+        add_region(std::move(main_diag));
+        add_region(std::move(anti_diag));
+        return *this;
+    }
+
+    // Jigsaw Sudoku: region_of[cell] names one of N irregular boxes, each of
+    // which must contain exactly N cells. Use instead of add_blocks().
+    Constraints &add_jigsaw(const std::array<int, SIZE> &region_of) {
+        std::array<Region, N> boxes;
+        for (int cell = 0; cell < SIZE; ++cell) {
+            int box = region_of[cell];
+            if (box < 0 || box >= N) {
+                throw std::invalid_argument("Jigsaw region id out of range");
+            }
+            boxes[box].push_back(cell);
+        }
+        for (auto &box : boxes) {
+            if (static_cast<int>(box.size()) != N) {
+                throw std::invalid_argument("Jigsaw region must have N cells");
+            }
+            add_region(std::move(box));
+        }
+        return *this;
+    }
+
+    // Killer Sudoku: cage cells are all different and sum to `sum`.
+    Constraints &add_cage(Region cells, int sum) {
+        add_region(cells);
+        cages_.push_back(Cage{std::move(cells), sum});
+        return *this;
+    }
+
+    const std::vector<Region> &regions() const { return regions_; }
+    const std::vector<Cage> &cages() const { return cages_; }
+
+private:
+    std::vector<Region> regions_;
+    std::vector<Cage> cages_;
+};
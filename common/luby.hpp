@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+
+// Luby restart sequence 1, 1, 2, 1, 1, 2, 4, 1, 1, 2, ... for i = 1, 2, 3, ...
+inline std::size_t luby(std::size_t i) {
+    while (true) {
+        std::size_t k = 1;
+        while ((std::size_t{1} << k) - 1 < i) {
+            ++k;
+        }
+        if (i == (std::size_t{1} << k) - 1) {
+            return std::size_t{1} << (k - 1);
+        }
+        i -= (std::size_t{1} << (k - 1)) - 1;
+    }
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+// Marks a hot kernel for function multiversioning: GCC and Clang emit an AVX2
+// clone and a baseline clone, and the loader picks one for the running CPU.
+// Enabled by the CMake option SUDOKU_MULTIVERSIONING.
+#if defined(SUDOKU_MULTIVERSIONING) && defined(__x86_64__) && defined(__linux__) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define SUDOKU_MULTIVERSION __attribute__((target_clones("avx2", "default")))
+#else
+#define SUDOKU_MULTIVERSION
+#endif
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include <string_view>
+#include "types.hpp"
+
+// Text format for puzzle files: one board per line, N * N cells in row-major
+// order. '.' or '0' is an empty cell, digits 1-9 then letters A-P stand for
+// 10-25. The digit N is stored as color 0, matching print_board(). Blank
+// lines and lines starting with '#' are skipped by readers.
+
+// Board size implied by a line's length, or 0 if it is not a board line.
+inline int infer_board_size(std::string_view line) {
+    switch (line.size()) {
+        case 16:
+            return 4;
+        case 81:
+            return 9;
+        case 256:
+            return 16;
+        case 625:
+            return 25;
+        default:
+            return 0;
+    }
+}
+
+inline bool is_board_line(std::string_view line) {
+    return !line.empty() && line[0] != '#';
+}
+
+// Returns the color for a cell character, -1 for empty, -2 if invalid.
+template <int N>
+constexpr int parse_cell(char c) {
+    int digit;
+    if (c == '.' || c == '0') {
+        return -1;
+    } else if (c >= '1' && c <= '9') {
+        digit = c - '0';
+    } else if (c >= 'A' && c <= 'P') {
+        digit = c - 'A' + 10;
+    } else if (c >= 'a' && c <= 'p') {
+        digit = c - 'a' + 10;
+    } else {
+        return -2;
+    }
+    return digit <= N ? digit % N : -2;
+}
+
+template <int N>
+constexpr char format_cell(int color) {
+    if (color < 0 || color >= N) {
+        return '.';
+    }
+    int digit = color == 0 ? N : color;
+    return digit < 10 ? static_cast<char>('0' + digit) : static_cast<char>('A' + digit - 10);
+}
+
+template <int N>
+bool parse_board(std::string_view line, std::array<std::array<Square, N>, N>& board) {
+    if (line.size() != static_cast<std::size_t>(N * N)) {
+        return false;
+    }
+    for (int i = 0; i < N * N; ++i) {
+        int color = parse_cell<N>(line[i]);
+        if (color == -2) {
+            return false;
+        }
+        board[i / N][i % N] = Square{i, color};
+    }
+    return true;
+}
+
+template <int N>
+std::string format_board(const std::array<std::array<Square, N>, N>& board) {
+    std::string line(N * N, '.');
+    for (int i = 0; i < N * N; ++i) {
+        line[i] = format_cell<N>(board[i / N][i % N].value);
+    }
+    return line;
+}
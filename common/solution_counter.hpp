@@ -0,0 +1,200 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "types.hpp"
+#include "constraints.hpp"
+
+// Counts the completions of a board up to a limit, e.g. to check that a
+// generated puzzle is unique (limit 2). Each region keeps a bitmask of the
+// colors it uses, so a cell's candidates are a few ORs. Cages are ignored.
+template <int N>
+class SolutionCounter {
+public:
+    static constexpr int SIZE = N * N;
+    static constexpr std::uint32_t FULL_MASK = (std::uint64_t{1} << N) - 1;
+    using Board = std::array<std::array<Square, N>, N>;
+
+    explicit SolutionCounter(const Constraints<N>& constraints = Constraints<N>::classic())
+        : regions(constraints.regions()), used(regions.size()) {
+        for (std::size_t r = 0; r < regions.size(); ++r) {
+            for (int cell : regions[r]) {
+                regions_of[cell].push_back(static_cast<int>(r));
+            }
+        }
+    }
+
+    // Number of solutions, counting no further than limit. Gives up after
+    // max_nodes search nodes (0 means no cap); see aborted().
+    std::size_t count(const Board& board, std::size_t limit = 2, std::size_t max_nodes = 0) {
+        start(limit, max_nodes, nullptr);
+        if (load(board)) {
+            search();
+        }
+        return found;
+    }
+
+    // Fills the empty cells with a random solution; false if there is none
+    bool complete(Board& board, std::mt19937& random) {
+        start(1, 0, &random);
+        if (!load(board) || (search(), found == 0)) {
+            return false;
+        }
+        for (int cell = 0; cell < SIZE; ++cell) {
+            board[cell / N][cell % N].value = solution[cell];
+        }
+        return true;
+    }
+
+    // Whether the last call hit its node cap before finishing
+    bool aborted() const { return aborted_; }
+    std::size_t get_nodes() const { return nodes; }
+
+private:
+    std::vector<std::vector<int>> regions;
+    std::array<std::vector<int>, SIZE> regions_of;
+    std::vector<std::uint32_t> used;  // Colors taken in each region
+    std::array<int, SIZE> values;
+    std::array<int, SIZE> solution;
+    std::size_t found = 0, limit = 0, nodes = 0, max_nodes = 0;
+    bool aborted_ = false;
+    std::mt19937* rng = nullptr;  // Shuffles the color order when set
+
+    void start(std::size_t limit, std::size_t max_nodes, std::mt19937* random) {
+        found = 0;
+        nodes = 0;
+        aborted_ = false;
+        this->limit = limit;
+        this->max_nodes = max_nodes == 0 ? SIZE_MAX : max_nodes;
+        rng = random;
+    }
+
+    std::uint32_t candidates(int cell) const {
+        std::uint32_t taken = 0;
+        for (int r : regions_of[cell]) {
+            taken |= used[r];
+        }
+        return FULL_MASK & ~taken;
+    }
+
+    void place(int cell, int color) {
+        values[cell] = color;
+        for (int r : regions_of[cell]) {
+            used[r] |= std::uint32_t{1} << color;
+        }
+    }
+
+    void clear(int cell, int color) {
+        values[cell] = -1;
+        for (int r : regions_of[cell]) {
+            used[r] &= ~(std::uint32_t{1} << color);
+        }
+    }
+
+    // False if two clues already clash
+    bool load(const Board& board) {
+        std::fill(used.begin(), used.end(), 0);
+        values.fill(-1);
+        for (int cell = 0; cell < SIZE; ++cell) {
+            int color = board[cell / N][cell % N].value;
+            if (color < 0 || color >= N) {
+                continue;
+            }
+            if (!(candidates(cell) >> color & 1)) {
+                return false;
+            }
+            place(cell, color);
+        }
+        return true;
+    }
+
+    // Branches on whichever has the fewest options: the most constrained
+    // empty cell, or the cells of a region that can still take a missing
+    // color (this catches hidden singles).
+    void search() {
+        if (++nodes > max_nodes) {
+            aborted_ = true;
+            return;
+        }
+
+        std::array<std::uint32_t, SIZE> cand;
+        int best_cell = -1;
+        int best_count = N + 1;
+        for (int cell = 0; cell < SIZE; ++cell) {
+            if (values[cell] != -1) {
+                continue;
+            }
+            cand[cell] = candidates(cell);
+            int count = std::popcount(cand[cell]);
+            if (count < best_count) {
+                best_cell = cell;
+                best_count = count;
+            }
+        }
+        if (best_cell == -1) {
+            solution = values;
+            found++;
+            return;
+        }
+
+        std::array<int, N> order;
+        int options = 0;
+        int best_region = -1, best_color = -1;
+        for (std::size_t r = 0; r < regions.size() && best_count > 1; ++r) {
+            if (static_cast<int>(regions[r].size()) != N) {
+                continue;  // Only a full region must contain every color
+            }
+            std::array<int, N> places{};
+            for (int cell : regions[r]) {
+                if (values[cell] == -1) {
+                    for (std::uint32_t mask = cand[cell]; mask; mask &= mask - 1) {
+                        places[std::countr_zero(mask)]++;
+                    }
+                }
+            }
+            for (int color = 0; color < N; ++color) {
+                if (!(used[r] >> color & 1) && places[color] < best_count) {
+                    best_region = static_cast<int>(r);
+                    best_color = color;
+                    best_count = places[color];
+                }
+            }
+        }
+
+        if (best_region == -1) {
+            for (std::uint32_t mask = cand[best_cell]; mask; mask &= mask - 1) {
+                order[options++] = std::countr_zero(mask);
+            }
+            if (rng) {
+                std::shuffle(order.begin(), order.begin() + options, *rng);
+            }
+            for (int i = 0; i < options && !done(); ++i) {
+                place(best_cell, order[i]);
+                search();
+                clear(best_cell, order[i]);
+            }
+            return;
+        }
+
+        for (int cell : regions[best_region]) {
+            if (values[cell] == -1 && (cand[cell] >> best_color & 1)) {
+                order[options++] = cell;
+            }
+        }
+        if (rng) {
+            std::shuffle(order.begin(), order.begin() + options, *rng);
+        }
+        for (int i = 0; i < options && !done(); ++i) {
+            place(order[i], best_color);
+            search();
+            clear(order[i], best_color);
+        }
+    }
+
+    bool done() const { return found >= limit || aborted_; }
+};
@@ -5,9 +5,18 @@
 #include "solvers/dsatur_solver.hpp"
 #include "solvers/backtracking_solver.hpp"
 #include "solvers/heuristic_kempe_solver.hpp"
+#include "solvers/portfolio_solver.hpp"
+#include "solvers/sat_solver.hpp"
+#include "solvers/tabu_solver.hpp"
 #include "common/types.hpp"
+#include "common/constraints.hpp"
+#include "common/validator.hpp"
 #include <cmath>
 #include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
 
 constexpr bool is_perfect_square(int n) {
     if (n <= 0)
@@ -23,9 +32,48 @@ enum class SolverType {
     Greedy,
     DSatur,
     Backtracking,
-    HeuristicKempe
+    RandomizedBacktracking,
+    HeuristicKempe,
+    Sat,
+    Tabu,
+    Portfolio
 };
 
+// Command line name of each solver, as used by main and the tools
+inline SolverType parse_solver_type(const std::string& type) {
+    if (type == "greedy") return SolverType::Greedy;
+    if (type == "dsatur") return SolverType::DSatur;
+    if (type == "backtrack") return SolverType::Backtracking;
+    if (type == "restart") return SolverType::RandomizedBacktracking;
+    if (type == "kempe") return SolverType::HeuristicKempe;
+    if (type == "sat") return SolverType::Sat;
+    if (type == "tabu") return SolverType::Tabu;
+    if (type == "portfolio") return SolverType::Portfolio;
+    throw std::invalid_argument("Invalid solver type");
+}
+
+inline std::string solver_type_to_string(SolverType type) {
+    switch (type) {
+        case SolverType::Greedy:
+            return "Greedy";
+        case SolverType::DSatur:
+            return "DSatur";
+        case SolverType::Backtracking:
+            return "Backtracking";
+        case SolverType::RandomizedBacktracking:
+            return "Randomized Backtracking";
+        case SolverType::HeuristicKempe:
+            return "Heuristic Kempe";
+        case SolverType::Sat:
+            return "SAT";
+        case SolverType::Tabu:
+            return "Tabu";
+        case SolverType::Portfolio:
+            return "Portfolio";
+    }
+    return "Unknown";
+}
+
 template <int N, SolverType Type>
     requires PerfectSquare<N>
 class SudokuSolver {
@@ -35,57 +83,41 @@ public:
     using Matrix = std::array<std::array<int, SIZE>, SIZE>;
 
     Board board;
+    Board clues;
     Matrix adjMatrix{};
+    Constraints<N> constraints;
+    SolveBudget budget;
     std::unique_ptr<BaseSolver<N>> solver;
 
-    SudokuSolver(const Board &initial_board) : board(initial_board) {
+    SudokuSolver(const Board &initial_board,
+                 Constraints<N> variant = Constraints<N>::classic())
+        : board(initial_board), clues(initial_board), constraints(std::move(variant)) {
         if constexpr (Type == SolverType::Greedy) {
             solver = std::make_unique<GreedySolver<N>>();
         } else if constexpr (Type == SolverType::DSatur) {
             solver = std::make_unique<DSaturSolver<N>>();
         } else if constexpr (Type == SolverType::Backtracking) {
             solver = std::make_unique<BacktrackingSolver<N>>();
-        } else {
+        } else if constexpr (Type == SolverType::RandomizedBacktracking) {
+            solver = std::make_unique<BacktrackingSolver<N>>(
+                BacktrackingOptions::randomized(std::random_device{}()));
+        } else if constexpr (Type == SolverType::HeuristicKempe) {
             solver = std::make_unique<HeuristicKempeSolver<N>>();
+        } else if constexpr (Type == SolverType::Sat) {
+            solver = std::make_unique<SatSolver<N>>();
+        } else if constexpr (Type == SolverType::Tabu) {
+            solver = std::make_unique<TabuSolver<N>>();
+        } else {
+            solver = std::make_unique<PortfolioSolver<N>>();
         }
     }
 
-    void create_row_deps() {
-        for (int i = 0; i < SIZE; ++i) {
-            for (int j = 0; j < N; ++j) {
-                int row_start = (i / N) * N;
-                int col = row_start + j;
-                if (col != i) {
-                    adjMatrix[i][col] += 1;
-                }
-            }
-        }
-    }
-
-    void create_col_deps() {
-        for (int i = 0; i < SIZE; ++i) {
-            for (int j = 0; j < N; ++j) {
-                int col_start = i % N;
-                int row = j * N + col_start;
-                if (row != i) {
-                    adjMatrix[i][row] += 1;
-                }
-            }
-        }
-    }
-
-    void create_block_deps() {
-        int block_size = static_cast<int>(std::sqrt(N));
-        for (int i = 0; i < SIZE; ++i) {
-            int row = i / N;
-            int col = i % N;
-            int block_row = row / block_size;
-            int block_col = col / block_size;
-            for (int dr = 0; dr < block_size; ++dr) {
-                for (int dc = 0; dc < block_size; ++dc) {
-                    int r = block_row * block_size + dr;
-                    int c = block_col * block_size + dc;
-                    int j = r * N + c;
+    // Every region (row, column, box, diagonal, jigsaw piece or cage) is an
+    // all-different constraint, i.e. a clique in the coloring graph.
+    void create_region_deps() {
+        for (const auto &region : constraints.regions()) {
+            for (int i : region) {
+                for (int j : region) {
                     if (j != i) {
                         adjMatrix[i][j] += 1;
                     }
@@ -103,10 +135,10 @@ public:
     }
 
     void solve() {
-        create_row_deps();
-        create_col_deps();
-        create_block_deps();
+        create_region_deps();
         normalize_adj_matrix();
+        solver->set_cages(constraints.cages());
+        solver->set_budget(budget);
         solver->solve(board, adjMatrix);
     }
 
@@ -135,4 +167,13 @@ public:
     std::size_t get_steps() const {
         return solver->get_steps();
     }
+
+    // Checks the current board against the regions, cages and clues
+    bool is_valid() const {
+        return BatchValidator<N>(constraints).validate_one(board, clues);
+    }
+
+    SolveStatus get_status() const {
+        return solver->get_status();
+    }
 }; 
\ No newline at end of file
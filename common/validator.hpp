@@ -0,0 +1,140 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "types.hpp"
+#include "constraints.hpp"
+#include "multiversion.hpp"
+
+// Checks finished boards against the regions and cages of a variant and
+// against their original clues. Boards are validated LANES at a time: every
+// cell becomes a one-hot mask (1 << color, 0 if out of range) stored
+// cell-major across the lanes, so each region check is an OR of masks that
+// vectorizes across boards.
+template <int N>
+class BatchValidator {
+public:
+    static constexpr int SIZE = N * N;
+    static constexpr int LANES = 8;  // 8 x 32-bit masks = one AVX2 register
+    static constexpr std::uint32_t FULL_MASK = (std::uint64_t{1} << N) - 1;
+    using Board = std::array<std::array<Square, N>, N>;
+
+    explicit BatchValidator(const Constraints<N>& constraints = Constraints<N>::classic())
+        : cages(constraints.cages()) {
+        for (const auto& region : constraints.regions()) {
+            auto& target = static_cast<int>(region.size()) == N ? full_regions : partial_regions;
+            target.push_back(region);
+        }
+    }
+
+    // valid[i] tells whether solutions[i] is a complete, valid coloring that
+    // keeps every clue of clues[i].
+    void validate(const Board* solutions, const Board* clues, std::size_t count,
+                  bool* valid) const {
+        std::vector<std::uint32_t> masks(SIZE * LANES);
+        std::vector<std::uint32_t> clue_masks(SIZE * LANES);
+        std::array<std::uint32_t, LANES> lane_ok;
+
+        for (std::size_t first = 0; first < count; first += LANES) {
+            std::size_t lanes = std::min<std::size_t>(LANES, count - first);
+            for (int cell = 0; cell < SIZE; ++cell) {
+                for (std::size_t lane = 0; lane < LANES; ++lane) {
+                    // Unused lanes get copies of the first board
+                    std::size_t board = first + (lane < lanes ? lane : 0);
+                    masks[cell * LANES + lane] =
+                        one_hot(solutions[board][cell / N][cell % N].value);
+                    clue_masks[cell * LANES + lane] =
+                        one_hot(clues[board][cell / N][cell % N].value);
+                }
+            }
+
+            lane_ok.fill(~std::uint32_t{0});
+            check_cells(masks.data(), clue_masks.data(), lane_ok.data());
+            for (const auto& region : full_regions) {
+                check_full_region(masks.data(), region.data(), lane_ok.data());
+            }
+
+            for (std::size_t lane = 0; lane < lanes; ++lane) {
+                valid[first + lane] = lane_ok[lane] != 0 &&
+                                      partial_regions_ok(masks.data(), lane) &&
+                                      cages_ok(solutions[first + lane]);
+            }
+        }
+    }
+
+    bool validate_one(const Board& solution, const Board& clue_board) const {
+        bool valid;
+        validate(&solution, &clue_board, 1, &valid);
+        return valid;
+    }
+
+private:
+    std::vector<std::vector<int>> full_regions;     // N cells: must OR to FULL_MASK
+    std::vector<std::vector<int>> partial_regions;  // Fewer cells: popcount check
+    std::vector<Cage> cages;
+
+    static std::uint32_t one_hot(int color) {
+        return color >= 0 && color < N ? std::uint32_t{1} << color : 0;
+    }
+
+    // Every cell colored, and clues (nonzero clue masks) kept
+    SUDOKU_MULTIVERSION
+    static void check_cells(const std::uint32_t* masks, const std::uint32_t* clue_masks,
+                            std::uint32_t* lane_ok) {
+        for (int cell = 0; cell < SIZE; ++cell) {
+            const std::uint32_t* m = masks + cell * LANES;
+            const std::uint32_t* c = clue_masks + cell * LANES;
+            for (int lane = 0; lane < LANES; ++lane) {
+                std::uint32_t colored = m[lane] != 0;
+                std::uint32_t kept = (c[lane] == 0) | (c[lane] == m[lane]);
+                lane_ok[lane] &= -(colored & kept);
+            }
+        }
+    }
+
+    // N one-hot cells are all different exactly when their OR has N bits
+    SUDOKU_MULTIVERSION
+    static void check_full_region(const std::uint32_t* masks, const int* cells,
+                                  std::uint32_t* lane_ok) {
+        std::uint32_t seen[LANES] = {};
+        for (int i = 0; i < N; ++i) {
+            const std::uint32_t* m = masks + cells[i] * LANES;
+            for (int lane = 0; lane < LANES; ++lane) {
+                seen[lane] |= m[lane];
+            }
+        }
+        for (int lane = 0; lane < LANES; ++lane) {
+            lane_ok[lane] &= -static_cast<std::uint32_t>(seen[lane] == FULL_MASK);
+        }
+    }
+
+    bool partial_regions_ok(const std::uint32_t* masks, std::size_t lane) const {
+        for (const auto& region : partial_regions) {
+            std::uint32_t seen = 0;
+            for (int cell : region) {
+                seen |= masks[cell * LANES + lane];
+            }
+            if (std::popcount(seen) != static_cast<int>(region.size())) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool cages_ok(const Board& board) const {
+        for (const auto& cage : cages) {
+            int sum = 0;
+            for (int cell : cage.cells) {
+                sum += color_to_digit<N>(board[cell / N][cell % N].value);
+            }
+            if (sum != cage.sum) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
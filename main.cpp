@@ -1,49 +1,72 @@
+#include <algorithm>
 #include <array>
+#include <fstream>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "boards/sudoku_boards.hpp"
+#include "common/batch_runner.hpp"
+#include "common/puzzle_io.hpp"
 #include "common/sudoku_solver.hpp"
 
 void print_usage(const char* program_name) {
-  std::cout << "Usage: " << program_name << " <solver_type> [board_name]\n"
+  std::cout << "Usage: " << program_name
+            << " <solver_type> [board_name] [budget options]\n"
+            << "       " << program_name
+            << " validate <puzzle_file> <solution_file>\n"
+            << "       " << program_name
+            << " batch <solver_type> <puzzle_file> [batch options]"
+               " [budget options]\n"
             << "Solver types:\n"
             << "  greedy - Greedy solver\n"
             << "  dsatur - DSatur solver\n"
             << "  backtrack - Backtracking solver\n"
+            << "  restart - Backtracking with randomized Luby restarts\n"
             << "  kempe - Heuristic Kempe solver\n"
+            << "  sat - CNF encoding solved by the built-in CDCL engine\n"
+            << "  tabu - DSatur repaired by tabu search\n"
+            << "  portfolio - Race all solvers, keep the first solution\n"
             << "Board names:\n"
             << "  4x4 - 4x4 board (default)\n"
             << "  9x9 - 9x9 board\n"
-            << "  9x9_extreme - Extreme 9x9 board\n";
+            << "  9x9_extreme - Extreme 9x9 board\n"
+            << "Budget options:\n"
+            << "  --time-ms <ms> - Stop after this much wall time\n"
+            << "  --max-nodes <n> - Stop after this many steps\n"
+            << "  --max-memory-mb <mb> - Stop above this resident memory\n"
+            << "Batch options:\n"
+            << "  --workers <n> - Worker processes (default: one per CPU)\n"
+            << "  --pin <core|numa|none> - Worker pinning (default: core)\n"
+            << "  --out <file> - Write solutions here instead of stdout\n"
+            << "  --retries <n> - Restarts of a crashing line before it is "
+               "skipped (default: 2)\n";
 }
 
-SolverType parse_solver_type(const std::string& type) {
-  if (type == "greedy") return SolverType::Greedy;
-  if (type == "dsatur") return SolverType::DSatur;
-  if (type == "backtrack") return SolverType::Backtracking;
-  if (type == "kempe") return SolverType::HeuristicKempe;
-  throw std::invalid_argument("Invalid solver type");
-}
-
-std::string solver_type_to_string(SolverType type) {
-  switch (type) {
-    case SolverType::Greedy:
-      return "Greedy";
-    case SolverType::DSatur:
-      return "DSatur";
-    case SolverType::Backtracking:
-      return "Backtracking";
-    case SolverType::HeuristicKempe:
-      return "Heuristic Kempe";
-    default:
-      return "Unknown";
+SolveBudget parse_budget_option(SolveBudget budget, const std::string& option,
+                                const std::string& value) {
+  std::size_t amount = std::stoul(value);
+  if (option == "--time-ms") {
+    budget.time = std::chrono::milliseconds(amount);
+  } else if (option == "--max-nodes") {
+    budget.nodes = amount;
+  } else if (option == "--max-memory-mb") {
+    budget.memory_bytes = amount * 1024 * 1024;
+  } else {
+    throw std::invalid_argument("Unknown option " + option);
   }
+  return budget;
 }
 
 template <int N, SolverType Type>
-void execute_solver(const std::array<std::array<Square, N>, N>& board) {
+void execute_solver(const std::array<std::array<Square, N>, N>& board,
+                    const SolveBudget& budget) {
   SudokuSolver<N, Type> solver(board);
+  solver.budget = budget;
   solver.print_board();
   std::cout << "=========================\n";
   std::cout << "Solving Sudoku...\n";
@@ -51,46 +74,318 @@ void execute_solver(const std::array<std::array<Square, N>, N>& board) {
   solver.solve();
   solver.print_board();
   std::cout << "Steps taken: " << solver.get_steps() << "\n";
+  std::cout << "Status: " << to_string(solver.get_status()) << "\n";
+  std::cout << "Valid: " << (solver.is_valid() ? "yes" : "no") << "\n";
+}
+
+// Board pairs of one size waiting to be validated CHUNK at a time
+template <int N>
+class ValidationBatch {
+ public:
+  // False if either line is not an N x N board
+  bool add(std::string_view puzzle_line, std::string_view solution_line,
+           std::size_t line, std::vector<std::size_t>& invalid_lines) {
+    Board clue_board, solved_board;
+    if (!parse_board<N>(puzzle_line, clue_board) ||
+        !parse_board<N>(solution_line, solved_board)) {
+      return false;
+    }
+    clue_boards_.push_back(clue_board);
+    solved_boards_.push_back(solved_board);
+    line_numbers_.push_back(line);
+    if (solved_boards_.size() == CHUNK) flush(invalid_lines);
+    return true;
+  }
+
+  void flush(std::vector<std::size_t>& invalid_lines) {
+    validator_.validate(solved_boards_.data(), clue_boards_.data(),
+                        solved_boards_.size(), valid_.get());
+    for (std::size_t i = 0; i < solved_boards_.size(); ++i) {
+      if (!valid_[i]) invalid_lines.push_back(line_numbers_[i]);
+    }
+    clue_boards_.clear();
+    solved_boards_.clear();
+    line_numbers_.clear();
+  }
+
+ private:
+  using Board = std::array<std::array<Square, N>, N>;
+  static constexpr std::size_t CHUNK = 1024;
+
+  BatchValidator<N> validator_;
+  std::vector<Board> clue_boards_, solved_boards_;
+  std::vector<std::size_t> line_numbers_;
+  std::unique_ptr<bool[]> valid_ = std::make_unique<bool[]>(CHUNK);
+};
+
+// Checks each solution line against the puzzle on the same line number.
+// Every line pair is validated at its own size, so a file may mix sizes.
+int validate_files(const std::string& puzzle_path,
+                   const std::string& solution_path) {
+  std::ifstream puzzles(puzzle_path), solutions(solution_path);
+  if (!puzzles || !solutions) {
+    std::cerr << "Cannot open " << (puzzles ? solution_path : puzzle_path)
+              << "\n";
+    return 1;
+  }
+
+  ValidationBatch<4> batch4;
+  ValidationBatch<9> batch9;
+  ValidationBatch<16> batch16;
+  ValidationBatch<25> batch25;
+  std::vector<std::size_t> invalid_lines, malformed_lines;
+  std::size_t checked = 0;
+
+  std::string puzzle_line, solution_line;
+  for (std::size_t line = 1; std::getline(puzzles, puzzle_line); ++line) {
+    if (!std::getline(solutions, solution_line)) solution_line.clear();
+    if (!is_board_line(puzzle_line)) continue;
+
+    checked++;
+    bool parsed = false;
+    switch (infer_board_size(puzzle_line)) {
+      case 4:
+        parsed = batch4.add(puzzle_line, solution_line, line, invalid_lines);
+        break;
+      case 9:
+        parsed = batch9.add(puzzle_line, solution_line, line, invalid_lines);
+        break;
+      case 16:
+        parsed = batch16.add(puzzle_line, solution_line, line, invalid_lines);
+        break;
+      case 25:
+        parsed = batch25.add(puzzle_line, solution_line, line, invalid_lines);
+        break;
+    }
+    if (!parsed) malformed_lines.push_back(line);
+  }
+  batch4.flush(invalid_lines);
+  batch9.flush(invalid_lines);
+  batch16.flush(invalid_lines);
+  batch25.flush(invalid_lines);
+
+  // Batches of different sizes flush out of order; report by line number
+  std::vector<std::pair<std::size_t, const char*>> reports;
+  for (std::size_t line : invalid_lines) reports.emplace_back(line, "invalid");
+  for (std::size_t line : malformed_lines) {
+    reports.emplace_back(line, "malformed");
+  }
+  std::sort(reports.begin(), reports.end());
+  for (const auto& [line, reason] : reports) {
+    std::cout << "line " << line << ": " << reason << "\n";
+  }
+
+  std::size_t invalid = reports.size();
+  std::cout << "Checked " << checked << " boards: " << checked - invalid
+            << " valid, " << invalid << " invalid\n";
+  return invalid == 0 ? 0 : 1;
 }
 
 template <int N>
 void solve_board_impl(const std::array<std::array<Square, N>, N>& board,
-                      SolverType type) {
+                      SolverType type, const SolveBudget& budget) {
   switch (type) {
     case SolverType::Greedy:
-      execute_solver<N, SolverType::Greedy>(board);
+      execute_solver<N, SolverType::Greedy>(board, budget);
       break;
     case SolverType::DSatur:
-      execute_solver<N, SolverType::DSatur>(board);
+      execute_solver<N, SolverType::DSatur>(board, budget);
       break;
     case SolverType::Backtracking:
-      execute_solver<N, SolverType::Backtracking>(board);
+      execute_solver<N, SolverType::Backtracking>(board, budget);
+      break;
+    case SolverType::RandomizedBacktracking:
+      execute_solver<N, SolverType::RandomizedBacktracking>(board, budget);
       break;
     case SolverType::HeuristicKempe:
-      execute_solver<N, SolverType::HeuristicKempe>(board);
+      execute_solver<N, SolverType::HeuristicKempe>(board, budget);
+      break;
+    case SolverType::Sat:
+      execute_solver<N, SolverType::Sat>(board, budget);
+      break;
+    case SolverType::Tabu:
+      execute_solver<N, SolverType::Tabu>(board, budget);
+      break;
+    case SolverType::Portfolio:
+      execute_solver<N, SolverType::Portfolio>(board, budget);
       break;
   }
 }
 
+// Batch workers solve on the heap: a 25x25 adjacency matrix is 1.5 MB
+template <int N, SolverType Type>
+BatchResult solve_line_as(const std::array<std::array<Square, N>, N>& board,
+                          const SolveBudget& budget) {
+  auto solver = std::make_unique<SudokuSolver<N, Type>>(board);
+  solver->budget = budget;
+  solver->solve();
+  return {solver->get_status(), format_board<N>(solver->board)};
+}
+
+template <int N>
+BatchResult solve_line_impl(std::string_view line, SolverType type,
+                            const SolveBudget& budget) {
+  std::array<std::array<Square, N>, N> board;
+  if (!parse_board<N>(line, board)) {
+    return {SolveStatus::Failed, std::string(line)};
+  }
+  switch (type) {
+    case SolverType::Greedy:
+      return solve_line_as<N, SolverType::Greedy>(board, budget);
+    case SolverType::DSatur:
+      return solve_line_as<N, SolverType::DSatur>(board, budget);
+    case SolverType::Backtracking:
+      return solve_line_as<N, SolverType::Backtracking>(board, budget);
+    case SolverType::RandomizedBacktracking:
+      return solve_line_as<N, SolverType::RandomizedBacktracking>(board, budget);
+    case SolverType::HeuristicKempe:
+      return solve_line_as<N, SolverType::HeuristicKempe>(board, budget);
+    case SolverType::Sat:
+      return solve_line_as<N, SolverType::Sat>(board, budget);
+    case SolverType::Tabu:
+      return solve_line_as<N, SolverType::Tabu>(board, budget);
+    case SolverType::Portfolio:
+      return solve_line_as<N, SolverType::Portfolio>(board, budget);
+  }
+  return {SolveStatus::Failed, std::string(line)};
+}
+
+BatchResult solve_line(std::string_view line, SolverType type,
+                       const SolveBudget& budget) {
+  switch (infer_board_size(line)) {
+    case 4:
+      return solve_line_impl<4>(line, type, budget);
+    case 9:
+      return solve_line_impl<9>(line, type, budget);
+    case 16:
+      return solve_line_impl<16>(line, type, budget);
+    case 25:
+      return solve_line_impl<25>(line, type, budget);
+    default:
+      return {SolveStatus::Failed, std::string(line)};
+  }
+}
+
+PinMode parse_pin_mode(const std::string& mode) {
+  if (mode == "core") return PinMode::Core;
+  if (mode == "numa") return PinMode::Numa;
+  if (mode == "none") return PinMode::None;
+  throw std::invalid_argument("Invalid pin mode " + mode);
+}
+
+// Solves every board of a puzzle file in parallel worker processes and
+// writes one output line per input line, so the result can be fed straight
+// to validate.
+int run_batch_mode(int argc, char* argv[]) {
+  if (argc < 4) {
+    print_usage(argv[0]);
+    return 1;
+  }
+  SolverType solver_type = parse_solver_type(argv[2]);
+  std::string puzzle_path = argv[3];
+  std::string out_path;
+  BatchOptions options;
+  options.workers = static_cast<int>(std::thread::hardware_concurrency());
+  SolveBudget budget;
+  for (int i = 4; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (i + 1 >= argc) throw std::invalid_argument("Missing value for " + arg);
+    std::string value = argv[++i];
+    if (arg == "--workers") {
+      options.workers = std::stoi(value);
+    } else if (arg == "--pin") {
+      options.pin = parse_pin_mode(value);
+    } else if (arg == "--out") {
+      out_path = value;
+    } else if (arg == "--retries") {
+      options.max_retries = std::stoi(value);
+    } else {
+      budget = parse_budget_option(budget, arg, value);
+    }
+  }
+
+  if (!std::ifstream(puzzle_path)) {
+    std::cerr << "Cannot open " << puzzle_path << "\n";
+    return 1;
+  }
+  std::ofstream out_file;
+  if (!out_path.empty()) {
+    out_file.open(out_path);
+    if (!out_file) {
+      std::cerr << "Cannot open " << out_path << "\n";
+      return 1;
+    }
+  }
+  std::ostream& out = out_path.empty() ? std::cout : out_file;
+
+  BatchSummary summary = run_batch(
+      puzzle_path, out,
+      [&](std::string_view line) {
+        return solve_line(line, solver_type, budget);
+      },
+      options);
+  out.flush();
+
+  std::cerr << "Processed " << summary.boards << " boards with "
+            << solver_type_to_string(solver_type) << ":";
+  for (SolveStatus status :
+       {SolveStatus::Solved, SolveStatus::Unsolvable, SolveStatus::Failed,
+        SolveStatus::BudgetExceeded, SolveStatus::Cancelled}) {
+    std::cerr << " " << summary.by_status[static_cast<int>(status)] << " "
+              << to_string(status) << ",";
+  }
+  std::cerr << " " << summary.crashed << " crashed, " << summary.restarts
+            << " worker restarts\n";
+  return summary.crashed == 0 ? 0 : 1;
+}
+
 int main(int argc, char* argv[]) {
   if (argc < 2) {
     print_usage(argv[0]);
     return 1;
   }
 
+  if (std::string(argv[1]) == "validate") {
+    if (argc != 4) {
+      print_usage(argv[0]);
+      return 1;
+    }
+    return validate_files(argv[2], argv[3]);
+  }
+
+  if (std::string(argv[1]) == "batch") {
+    try {
+      return run_batch_mode(argc, argv);
+    } catch (const std::exception& e) {
+      std::cerr << "Error: " << e.what() << "\n";
+      print_usage(argv[0]);
+      return 1;
+    }
+  }
+
   try {
     SolverType solver_type = parse_solver_type(argv[1]);
-    std::string board_name = (argc > 2) ? argv[2] : "4x4";
+    std::string board_name = "4x4";
+    SolveBudget budget;
+    for (int i = 2; i < argc; ++i) {
+      std::string arg = argv[i];
+      if (arg.rfind("--", 0) == 0) {
+        if (i + 1 >= argc) throw std::invalid_argument("Missing value for " + arg);
+        budget = parse_budget_option(budget, arg, argv[++i]);
+      } else {
+        board_name = arg;
+      }
+    }
 
     std::cout << "Using " << solver_type_to_string(solver_type) << " solver on "
               << board_name << " board:\n";
 
     if (board_name == "4x4") {
-      solve_board_impl<4>(SudokuBoards::BOARD_4x4, solver_type);
+      solve_board_impl<4>(SudokuBoards::BOARD_4x4, solver_type, budget);
     } else if (board_name == "9x9") {
-      solve_board_impl<9>(SudokuBoards::BOARD_9x9, solver_type);
+      solve_board_impl<9>(SudokuBoards::BOARD_9x9, solver_type, budget);
     } else if (board_name == "9x9_extreme") {
-      solve_board_impl<9>(SudokuBoards::BOARD_9x9_EXTREME, solver_type);
+      solve_board_impl<9>(SudokuBoards::BOARD_9x9_EXTREME, solver_type, budget);
     } else {
       std::cerr
           << "Invalid board name. Must be '4x4', '9x9', or '9x9_extreme'.\n";
@@ -1,8 +1,39 @@
 #pragma once
 
 #include "base_solver.hpp"
+#include "../common/luby.hpp"
+#include "../common/multiversion.hpp"
 #include <algorithm>
+#include <bit>
+#include <cstdint>
 #include <iostream>
+#include <random>
+
+enum class RestartPolicy {
+    None,
+    Luby,
+    Geometric
+};
+
+struct BacktrackingOptions {
+    RestartPolicy restarts = RestartPolicy::None;
+    std::size_t restart_base = 64;  // Color attempts allowed in the first run
+    double restart_growth = 1.5;    // Run length factor for Geometric
+    bool randomize_ties = false;    // Break ordering ties randomly
+    bool weight_conflicts = false;  // dom/wdeg: prefer cells that hit dead ends
+    std::uint64_t seed = 0;
+
+    // Luby restarts with randomized ties and conflict weights kept across
+    // runs; cuts off the heavy tail of runaway searches.
+    static BacktrackingOptions randomized(std::uint64_t seed) {
+        BacktrackingOptions options;
+        options.restarts = RestartPolicy::Luby;
+        options.randomize_ties = true;
+        options.weight_conflicts = true;
+        options.seed = seed;
+        return options;
+    }
+};
 
 template <int N>
 class BacktrackingSolver : public BaseSolver<N> {
@@ -10,46 +41,79 @@ class BacktrackingSolver : public BaseSolver<N> {
     using typename BaseSolver<N>::Matrix;
     using BaseSolver<N>::SIZE;
 
-private:
+protected:
     const Matrix* adjMatrix;
-    std::array<int, SIZE> best_values;
+    std::array<int, SIZE> best_values;  // Deepest partial assignment so far
+    int best_depth = -1;
+
+    BacktrackingOptions options;
+    std::mt19937_64 rng;
+    std::array<int, SIZE> weights;  // Dead ends seen at each cell
+    std::size_t run_limit = 0;      // Color attempts left before restarting
+    bool restart_pending = false;
+
+    std::size_t run_length(std::size_t run) const {
+        if (options.restarts == RestartPolicy::Luby) {
+            return options.restart_base * luby(run + 1);
+        }
+        double length = static_cast<double>(options.restart_base);
+        for (std::size_t i = 0; i < run; ++i) {
+            length *= options.restart_growth;
+        }
+        return static_cast<std::size_t>(length);
+    }
 
+    // Branch-free so the scan vectorizes
+    SUDOKU_MULTIVERSION
     bool is_safe(const std::array<int, SIZE>& values, int pos, int color) {
+        const auto& neighbors = (*adjMatrix)[pos];
+        int conflicts = 0;
         for (int i = 0; i < SIZE; ++i) {
-            if ((*adjMatrix)[pos][i] && values[i] == color) {
-                return false;
-            }
+            conflicts |= (neighbors[i] != 0) & (values[i] == color);
         }
-        return true;
+        return !conflicts && this->cages_allow(values, pos, color);
     }
 
     int find_mrv_position(const std::array<int, SIZE>& values) {
         int min_remaining = N + 1;
+        int min_weight = 1;
         int chosen_pos = -1;
+        int ties = 0;
 
         for (int pos = 0; pos < SIZE; ++pos) {
             if (values[pos] == -1) {
                 int remaining = count_remaining_values(values, pos);
-                if (remaining < min_remaining) {
+                int weight = options.weight_conflicts ? weights[pos] : 1;
+                // remaining / weight < min_remaining / min_weight
+                long lhs = static_cast<long>(remaining) * min_weight;
+                long rhs = static_cast<long>(min_remaining) * weight;
+                if (lhs < rhs) {
                     min_remaining = remaining;
+                    min_weight = weight;
+                    chosen_pos = pos;
+                    ties = 1;
+                } else if (lhs == rhs && options.randomize_ties &&
+                           std::uniform_int_distribution<int>(0, ties++)(rng) == 0) {
                     chosen_pos = pos;
                 }
             }
         }
+
         return chosen_pos;
     }
 
+    // Colors taken by neighbors as a bitmask; the variable shifts vectorize
+    // with AVX2
+    SUDOKU_MULTIVERSION
     int count_remaining_values(const std::array<int, SIZE>& values, int pos) {
-        std::array<bool, N> available;
-        std::fill(available.begin(), available.end(), true);
-
+        const auto& neighbors = (*adjMatrix)[pos];
+        std::uint32_t used = 0;
         for (int i = 0; i < SIZE; ++i) {
-            if ((*adjMatrix)[pos][i] && values[i] != -1 && values[i] < N) {
-                available[values[i]] = false;
-            }
+            int value = values[i];
+            bool taken = neighbors[i] && value >= 0 && value < N;
+            used |= taken ? std::uint32_t{1} << value : 0;
         }
-
-        return std::count(available.begin(), available.end(), true);
+        return N - std::popcount(used);
     }
 
     int count_constraints(const std::array<int, SIZE>& values, int pos, int color) {
@@ -65,6 +129,10 @@ private:
     }
 
     bool backtrack_solve(std::array<int, SIZE>& values, int depth) {
+        if (depth > best_depth) {
+            best_depth = depth;
+            best_values = values;
+        }
         if (depth >= SIZE) {
             return true;
         }
@@ -74,13 +142,31 @@ private:
             return true;
         }
 
+        // Scoring costs N * SIZE^2 on big boards; poll between colors so a
+        // time limit is not overshot by a whole node
         std::array<std::pair<int, int>, N> color_constraints;
         for (int color = 0; color < N; ++color) {
+            if (this->should_stop()) {
+                return false;
+            }
             color_constraints[color] = {count_constraints(values, pos, color), color};
         }
-        std::sort(color_constraints.begin(), color_constraints.end());
+        if (options.randomize_ties) {
+            std::shuffle(color_constraints.begin(), color_constraints.end(), rng);
+            std::stable_sort(color_constraints.begin(), color_constraints.end(),
+                             [](const auto& a, const auto& b) { return a.first < b.first; });
+        } else {
+            std::sort(color_constraints.begin(), color_constraints.end());
+        }
 
         for (const auto& [constraints, color] : color_constraints) {
+            if (this->should_stop()) {
+                return false;
+            }
+            if (options.restarts != RestartPolicy::None && run_limit-- == 0) {
+                restart_pending = true;
+                return false;
+            }
             this->steps++;  // Count each color attempt
             if (is_safe(values, pos, color)) {
                 values[pos] = color;
@@ -88,39 +174,72 @@ private:
                     return true;
                 }
                 values[pos] = -1;
+                if (restart_pending) {
+                    return false;
+                }
             }
         }
 
-        // Save the current state as the best attempt
-        best_values = values;
+        weights[pos]++;
         return false;
     }
 
 public:
+    explicit BacktrackingSolver(BacktrackingOptions opts = {})
+        : options(opts), rng(opts.seed) {}
+
     void solve(Board& board, const Matrix& adj_matrix) override {
         adjMatrix = &adj_matrix;
-        std::array<int, SIZE> values;
-        std::fill(values.begin(), values.end(), -1);
-        std::fill(best_values.begin(), best_values.end(), -1);
+        std::array<int, SIZE> initial;
+        std::fill(initial.begin(), initial.end(), -1);
+        best_depth = -1;
+        std::fill(weights.begin(), weights.end(), 1);
 
         for (int i = 0; i < SIZE; ++i) {
             if (board[i / N][i % N].value != -1) {
-                values[i] = board[i / N][i % N].value;
-                best_values[i] = values[i];
+                initial[i] = board[i / N][i % N].value;
             }
         }
 
-        if (backtrack_solve(values, 0)) {
+        // Each run starts from the clues; weights and the RNG carry over
+        std::array<int, SIZE> values;
+        bool solved = false;
+        for (std::size_t run = 0;; ++run) {
+            values = initial;
+            run_limit = run_length(run);
+            restart_pending = false;
+            solved = backtrack_solve(values, 0);
+            if (solved || !restart_pending) {
+                break;
+            }
+        }
+        this->finish(solved);
+        if (solved) {
             // If we found a solution, use the solved values
             for (int i = 0; i < SIZE; ++i) {
                 board[i / N][i % N].value = values[i];
             }
         } else {
-            std::cerr << "No solution exists for this puzzle.\n";
-            // If we failed, use the best attempt
+            if (!this->stopped()) {
+                std::cerr << "No solution exists for this puzzle.\n";
+            }
+            // If we failed, use the deepest attempt
             for (int i = 0; i < SIZE; ++i) {
                 board[i / N][i % N].value = best_values[i];
             }
         }
     }
-}; 
\ No newline at end of file
+}; 
+
+template <int N>
+void BaseSolver<N>::solve_with_backtracker(Board& board, const Matrix& adjMatrix) {
+    BacktrackingSolver<N> fallback;
+    if (cage_list) {
+        fallback.set_cages(*cage_list);
+    }
+    fallback.set_stop_token(stop_token);
+    fallback.set_budget(budget, budget_start);
+    fallback.solve(board, adjMatrix);
+    steps += fallback.get_steps();
+    status = fallback.get_status();
+}
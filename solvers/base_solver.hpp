@@ -1,8 +1,13 @@
 #pragma once
 
 #include <array>
+#include <chrono>
 #include <cstddef>
+#include <stop_token>
+#include <vector>
 #include "../common/types.hpp"
+#include "../common/constraints.hpp"
+#include "../common/budget.hpp"
 
 template <int N>
 class BaseSolver {
@@ -15,8 +20,119 @@ public:
     virtual void solve(Board& board, const Matrix& adjMatrix) = 0;
     virtual ~BaseSolver() = default;
 
+    using Clock = std::chrono::steady_clock;
+
     std::size_t get_steps() const { return steps; }
+    SolveStatus get_status() const { return status; }
+    bool is_solved() const { return status == SolveStatus::Solved; }
+
+    // Lets a caller (e.g. the portfolio) cancel a running search.
+    void set_stop_token(std::stop_token token) { stop_token = token; }
+
+    // Limits the next solve; the time limit counts from start.
+    void set_budget(const SolveBudget& limits, Clock::time_point start = Clock::now()) {
+        budget = limits;
+        budget_start = start;
+        deadline = start + limits.time;
+        budget_polls = 0;
+        cancelled = false;
+        budget_exceeded = false;
+    }
+
+    // Cage sums are not expressible as graph edges, so solvers check them
+    // alongside the adjacency matrix when picking a color.
+    void set_cages(const std::vector<Cage>& cages) {
+        cage_list = &cages;
+        for (auto& list : cages_of) {
+            list.clear();
+        }
+        for (int c = 0; c < static_cast<int>(cages.size()); ++c) {
+            for (int cell : cages[c].cells) {
+                cages_of[cell].push_back(c);
+            }
+        }
+    }
 
 protected:
+    // Resident memory is read from /proc, so it is only sampled once per this
+    // many should_stop() calls
+    static constexpr std::size_t MEMORY_POLL_INTERVAL = 1024;
+
     std::size_t steps;
-}; 
\ No newline at end of file
+    SolveStatus status = SolveStatus::Unsolvable;
+    std::stop_token stop_token;
+    SolveBudget budget;
+    Clock::time_point budget_start = Clock::now();
+    Clock::time_point deadline;
+    std::size_t budget_polls = 0;
+    bool cancelled = false;
+    bool budget_exceeded = false;
+    const std::vector<Cage>* cage_list = nullptr;
+    std::array<std::vector<int>, SIZE> cages_of;
+
+    // Polled from the search loops, so it has to stay cheap: the node limit
+    // is a compare, the stop token an atomic load and the clock a vDSO call,
+    // all far below the cost of one search node.
+    bool should_stop() {
+        if (cancelled || budget_exceeded) {
+            return true;
+        }
+        if (stop_token.stop_requested()) {
+            cancelled = true;
+        } else if (budget.nodes && steps >= budget.nodes) {
+            budget_exceeded = true;
+        } else if (budget.time.count() && Clock::now() >= deadline) {
+            budget_exceeded = true;
+        } else if (budget.memory_bytes && ++budget_polls % MEMORY_POLL_INTERVAL == 0) {
+            budget_exceeded = resident_memory() > budget.memory_bytes;
+        }
+        return cancelled || budget_exceeded;
+    }
+
+    bool stopped() const { return cancelled || budget_exceeded; }
+
+    // Hands the board to a BacktrackingSolver sharing this solver's cages,
+    // stop token and budget, e.g. for constraints a solver cannot encode.
+    // Defined in backtracking_solver.hpp.
+    void solve_with_backtracker(Board& board, const Matrix& adjMatrix);
+
+    // Only an exhaustive search may conclude that there is no solution;
+    // heuristics that give up report Failed instead.
+    void finish(bool solved, bool exhaustive = true) {
+        if (solved) {
+            status = SolveStatus::Solved;
+        } else if (cancelled) {
+            status = SolveStatus::Cancelled;
+        } else if (budget_exceeded) {
+            status = SolveStatus::BudgetExceeded;
+        } else {
+            status = exhaustive ? SolveStatus::Unsolvable : SolveStatus::Failed;
+        }
+    }
+
+    // Whether every cage through pos can still reach its sum with color there.
+    bool cages_allow(const std::array<int, SIZE>& values, int pos, int color) const {
+        for (int c : cages_of[pos]) {
+            const Cage& cage = (*cage_list)[c];
+            int sum = color_to_digit<N>(color);
+            int empty = 0;
+            for (int cell : cage.cells) {
+                if (cell == pos) {
+                    continue;
+                }
+                if (values[cell] == -1) {
+                    empty++;
+                } else {
+                    sum += color_to_digit<N>(values[cell]);
+                }
+            }
+            if (sum + empty > cage.sum || sum + empty * N < cage.sum) {
+                return false;
+            }
+            if (empty == 0 && sum != cage.sum) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
@@ -11,6 +11,28 @@ class DSaturSolver : public BaseSolver<N> {
     using typename BaseSolver<N>::Matrix;
     using BaseSolver<N>::SIZE;
 
+protected:
+    // Uncolored vertex with the highest saturation, ties broken by degree
+    int select_vertex(const std::array<std::unordered_set<int>, SIZE>& neighbor_colors,
+                      const std::array<int, SIZE>& degrees,
+                      const std::array<bool, SIZE>& colored) const {
+        int max_sat = -1, max_deg = -1, selected = -1;
+
+        for (int i = 0; i < SIZE; ++i) {
+            if (colored[i])
+                continue;
+
+            int sat = static_cast<int>(neighbor_colors[i].size());
+
+            if (sat > max_sat || (sat == max_sat && degrees[i] > max_deg)) {
+                max_sat = sat;
+                max_deg = degrees[i];
+                selected = i;
+            }
+        }
+        return selected;
+    }
+
 public:
     void solve(Board& board, const Matrix& adjMatrix) override {
         std::array<int, SIZE> colors;
@@ -33,23 +55,23 @@ public:
             }
         }
 
+        // Clues are colored from the start and saturate their neighbors
+        int open = SIZE;
+        for (int i = 0; i < SIZE; ++i) {
+            if (colors[i] == -1)
+                continue;
+            colored[i] = true;
+            open--;
+            for (int j = 0; j < SIZE; ++j) {
+                if (adjMatrix[i][j])
+                    neighbor_colors[j].insert(colors[i]);
+            }
+        }
+
         bool failed = false;
-        for (int step = 0; step < SIZE; ++step) {
+        for (int step = 0; step < open && !this->should_stop(); ++step) {
             this->steps++;  // Count each vertex coloring attempt
-            int max_sat = -1, max_deg = -1, selected = -1;
-
-            for (int i = 0; i < SIZE; ++i) {
-                if (colored[i])
-                    continue;
-
-                int sat = static_cast<int>(neighbor_colors[i].size());
-
-                if (sat > max_sat || (sat == max_sat && degrees[i] > max_deg)) {
-                    max_sat = sat;
-                    max_deg = degrees[i];
-                    selected = i;
-                }
-            }
+            int selected = select_vertex(neighbor_colors, degrees, colored);
 
             std::array<bool, N> available{};
             available.fill(true);
@@ -62,7 +84,7 @@ public:
 
             int chosen_color = -1;
             for (int c = 0; c < N; ++c) {
-                if (available[c]) {
+                if (available[c] && this->cages_allow(colors, selected, c)) {
                     chosen_color = c;
                     break;
                 }
@@ -85,6 +107,7 @@ public:
             }
         }
 
+        this->finish(!failed && !this->stopped(), false);
         // Always apply the colorings, even if we failed
         for (int i = 0; i < SIZE; ++i) {
             board[i / N][i % N].value = colors[i];
@@ -22,7 +22,10 @@ public:
         }
 
         bool failed = false;
-        for (int i = 0; i < SIZE; ++i) {
+        for (int i = 0; i < SIZE && !this->should_stop(); ++i) {
+            if (board[i / N][i % N].value != -1) {
+                continue;  // Clues keep their color
+            }
             this->steps++;  // Count each vertex coloring attempt
             std::array<bool, N> available;
             std::fill(available.begin(), available.end(), true);
@@ -35,7 +38,7 @@ public:
 
             int color = -1;
             for (int c = 0; c < N; ++c) {
-                if (available[c]) {
+                if (available[c] && this->cages_allow(values, i, c)) {
                     color = c;
                     break;
                 }
@@ -50,6 +53,7 @@ public:
             values[i] = color;
         }
 
+        this->finish(!failed && !this->stopped(), false);
         // Always apply the colorings, even if we failed
         for (int i = 0; i < SIZE; ++i) {
             board[i / N][i % N].value = values[i];
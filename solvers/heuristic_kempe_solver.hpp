@@ -1,6 +1,7 @@
 #pragma once
 
 #include "base_solver.hpp"
+#include "../common/multiversion.hpp"
 #include <unordered_set>
 #include <algorithm>
 #include <iostream>
@@ -11,19 +12,19 @@ class HeuristicKempeSolver : public BaseSolver<N> {
     using typename BaseSolver<N>::Matrix;
     using BaseSolver<N>::SIZE;
 
-private:
+protected:
     const Matrix* adjMatrix;
     static constexpr int K = N;  // K is equal to N (4 or 9)
-    std::array<int, SIZE> best_values;
+    std::array<int, SIZE> best_values;  // Deepest partial assignment so far
+    int best_depth = -1;
 
+    SUDOKU_MULTIVERSION
     int find_vertex_with_degree_less_than_k(const std::array<int, SIZE>& values) {
         for (int i = 0; i < SIZE; ++i) {
             if (values[i] == -1) {  // Only consider uncolored vertices
                 int degree = 0;
                 for (int j = 0; j < SIZE; ++j) {
-                    if ((*adjMatrix)[i][j]) {  // Count all adjacent vertices
-                        degree++;
-                    }
+                    degree += (*adjMatrix)[i][j] != 0;  // Count all adjacent vertices
                 }
                 if (degree < K) {
                     return i;
@@ -43,13 +44,14 @@ private:
         return used_colors;
     }
 
+    SUDOKU_MULTIVERSION
     bool is_valid_color(const std::array<int, SIZE>& values, int vertex, int color) {
+        const auto& neighbors = (*adjMatrix)[vertex];
+        int conflicts = 0;
         for (int i = 0; i < SIZE; ++i) {
-            if ((*adjMatrix)[vertex][i] && values[i] == color) {
-                return false;
-            }
+            conflicts |= (neighbors[i] != 0) & (values[i] == color);
         }
-        return true;
+        return !conflicts && this->cages_allow(values, vertex, color);
     }
 
     bool recursive_solve(std::array<int, SIZE>& values, int depth = 0) {
@@ -59,6 +61,14 @@ private:
             return false;
         }
 
+        if (this->should_stop()) {
+            return false;
+        }
+        if (depth > best_depth) {
+            best_depth = depth;
+            best_values = values;
+        }
+
         // Find a vertex with degree less than K
         int vertex = find_vertex_with_degree_less_than_k(values);
         
@@ -84,8 +94,9 @@ private:
         if (used_colors.size() < K) {
             // Try each unused color
             bool found_color = false;
-            for (int color = 0; color < K; ++color) {
-                if (used_colors.find(color) == used_colors.end()) {
+            for (int color = 0; color < K && !this->stopped(); ++color) {
+                if (used_colors.find(color) == used_colors.end() &&
+                    this->cages_allow(values, vertex, color)) {
                     this->steps++;  // Count each color attempt
                     values[vertex] = color;
                     if (recursive_solve(values, depth + 1)) {
@@ -101,7 +112,7 @@ private:
         } else {
             // If K or more colors are used, try each color
             bool found_color = false;
-            for (int color = 0; color < K; ++color) {
+            for (int color = 0; color < K && !this->stopped(); ++color) {
                 if (is_valid_color(values, vertex, color)) {
                     this->steps++;  // Count each color attempt
                     values[vertex] = color;
@@ -128,6 +139,7 @@ public:
         std::array<int, SIZE> values;
         std::fill(values.begin(), values.end(), -1);
         std::fill(best_values.begin(), best_values.end(), -1);
+        best_depth = -1;
 
         // Initialize with pre-colored values
         for (int i = 0; i < SIZE; ++i) {
@@ -138,7 +150,8 @@ public:
         }
 
         bool success = recursive_solve(values);
-        if (!success) {
+        this->finish(success);
+        if (!success && !this->stopped()) {
             std::cerr << "Heuristic Kempe solver failed to find a solution.\n";
             // Print where it got stuck
             for (int i = 0; i < SIZE; ++i) {
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "base_solver.hpp"
+#include "greedy_solver.hpp"
+#include "dsatur_solver.hpp"
+#include "backtracking_solver.hpp"
+#include "heuristic_kempe_solver.hpp"
+#include "sat_solver.hpp"
+#include "tabu_solver.hpp"
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+// Races several strategies on their own threads and keeps the first complete
+// coloring. The others are cancelled through a shared stop token, so the
+// solve takes about as long as the fastest strategy for this puzzle.
+template <int N>
+class PortfolioSolver : public BaseSolver<N> {
+    using typename BaseSolver<N>::Board;
+    using typename BaseSolver<N>::Matrix;
+    using BaseSolver<N>::SIZE;
+
+private:
+    static std::vector<std::unique_ptr<BaseSolver<N>>> make_strategies() {
+        std::vector<std::unique_ptr<BaseSolver<N>>> strategies;
+        strategies.push_back(std::make_unique<GreedySolver<N>>());
+        strategies.push_back(std::make_unique<DSaturSolver<N>>());
+        strategies.push_back(std::make_unique<BacktrackingSolver<N>>());
+        strategies.push_back(std::make_unique<HeuristicKempeSolver<N>>());
+        strategies.push_back(std::make_unique<SatSolver<N>>());
+        strategies.push_back(std::make_unique<TabuSolver<N>>());
+        // Differently seeded restarting backtrackers diversify the race
+        for (std::uint64_t seed = 1; seed <= 2; ++seed) {
+            strategies.push_back(std::make_unique<BacktrackingSolver<N>>(
+                BacktrackingOptions::randomized(seed)));
+        }
+        return strategies;
+    }
+
+    // Index of the complete solver whose best attempt is kept if nobody wins
+    static constexpr std::size_t FALLBACK = 2;
+
+public:
+    void solve(Board& board, const Matrix& adjMatrix) override {
+        auto strategies = make_strategies();
+        std::vector<Board> attempts(strategies.size(), board);
+
+        std::stop_source stop;
+        // Cancelling the portfolio cancels every strategy
+        std::stop_callback forward(this->stop_token, [&stop] { stop.request_stop(); });
+
+        std::mutex mutex;
+        int winner = -1;
+        {
+            std::vector<std::jthread> threads;
+            for (std::size_t i = 0; i < strategies.size(); ++i) {
+                BaseSolver<N>& strategy = *strategies[i];
+                if (this->cage_list) {
+                    strategy.set_cages(*this->cage_list);
+                }
+                strategy.set_stop_token(stop.get_token());
+                strategy.set_budget(this->budget, this->budget_start);
+                threads.emplace_back([&, i] {
+                    strategy.solve(attempts[i], adjMatrix);
+                    if (!strategy.is_solved()) {
+                        return;
+                    }
+                    std::lock_guard lock(mutex);
+                    if (winner == -1) {
+                        winner = static_cast<int>(i);
+                        stop.request_stop();
+                    }
+                });
+            }
+        }  // jthreads join here
+
+        if (winner != -1) {
+            board = attempts[winner];
+            this->steps += strategies[winner]->get_steps();
+            this->status = SolveStatus::Solved;
+            return;
+        }
+
+        // A complete strategy proving unsolvability beats a budget stop,
+        // which beats heuristics giving up
+        board = attempts[FALLBACK];
+        this->status = SolveStatus::Failed;
+        for (const auto& strategy : strategies) {
+            this->steps += strategy->get_steps();
+            SolveStatus status = strategy->get_status();
+            if (status == SolveStatus::Unsolvable ||
+                (status == SolveStatus::BudgetExceeded &&
+                 this->status == SolveStatus::Failed)) {
+                this->status = status;
+            }
+        }
+        if (this->stop_token.stop_requested()) {
+            this->status = SolveStatus::Cancelled;
+        }
+    }
+};
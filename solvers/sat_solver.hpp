@@ -0,0 +1,172 @@
+#pragma once
+
+#include "base_solver.hpp"
+#include "backtracking_solver.hpp"
+#include "../common/cdcl.hpp"
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+// Encodes the coloring graph as CNF and hands it to the in-tree CDCL engine.
+// One variable per (cell, color) left open by the clues; the graph is split
+// into cliques so each color gets a single at-most-one constraint per region
+// instead of one clause per edge.
+template <int N>
+class SatSolver : public BaseSolver<N> {
+    using typename BaseSolver<N>::Board;
+    using typename BaseSolver<N>::Matrix;
+    using BaseSolver<N>::SIZE;
+
+private:
+    // Above this many literals a sequential counter beats pairwise clauses
+    static constexpr std::size_t PAIRWISE_LIMIT = 6;
+
+    cdcl::Solver sat;
+    std::array<std::array<int, N>, SIZE> vars;  // -1 if the color is ruled out
+
+    void at_most_one(const std::vector<cdcl::Lit>& lits) {
+        if (lits.size() <= PAIRWISE_LIMIT) {
+            for (std::size_t i = 0; i < lits.size(); ++i) {
+                for (std::size_t j = i + 1; j < lits.size(); ++j) {
+                    sat.add_clause({cdcl::negate(lits[i]), cdcl::negate(lits[j])});
+                }
+            }
+            return;
+        }
+        // Sinz sequential counter: s_i means one of lits[0..i] is true
+        cdcl::Lit prev = cdcl::make_lit(sat.new_var());
+        sat.add_clause({cdcl::negate(lits[0]), prev});
+        for (std::size_t i = 1; i + 1 < lits.size(); ++i) {
+            cdcl::Lit next = cdcl::make_lit(sat.new_var());
+            sat.add_clause({cdcl::negate(lits[i]), next});
+            sat.add_clause({cdcl::negate(prev), next});
+            sat.add_clause({cdcl::negate(lits[i]), cdcl::negate(prev)});
+            prev = next;
+        }
+        sat.add_clause({cdcl::negate(lits.back()), cdcl::negate(prev)});
+    }
+
+    // Greedy clique cover of the edges; recovers rows, columns and boxes
+    // (or whatever regions the variant compiled in).
+    std::vector<std::vector<int>> find_cliques(const Matrix& adjMatrix) {
+        std::vector<std::vector<int>> cliques;
+        std::vector<bool> covered(SIZE * SIZE, false);
+        // Cubic in SIZE, so it polls the budget too
+        for (int i = 0; i < SIZE && !this->should_stop(); ++i) {
+            for (int j = i + 1; j < SIZE; ++j) {
+                if (!adjMatrix[i][j] || covered[i * SIZE + j]) {
+                    continue;
+                }
+                std::vector<int> clique{i, j};
+                for (int k = 0; k < SIZE; ++k) {
+                    bool joins = k != i && k != j;
+                    for (std::size_t m = 0; joins && m < clique.size(); ++m) {
+                        joins = adjMatrix[k][clique[m]] != 0;
+                    }
+                    if (joins) {
+                        clique.push_back(k);
+                    }
+                }
+                for (int a : clique) {
+                    for (int b : clique) {
+                        covered[a * SIZE + b] = true;
+                    }
+                }
+                cliques.push_back(std::move(clique));
+            }
+        }
+        return cliques;
+    }
+
+    void encode(const std::array<int, SIZE>& values, const Matrix& adjMatrix) {
+        for (auto& cell_vars : vars) {
+            cell_vars.fill(-1);
+        }
+        // Building the clauses is not free on big boards; a stop leaves a
+        // partial encoding that the solve gives up on at its first poll
+        for (int cell = 0; cell < SIZE && !this->should_stop(); ++cell) {
+            if (values[cell] != -1) {
+                continue;
+            }
+            std::array<bool, N> available;
+            available.fill(true);
+            for (int j = 0; j < SIZE; ++j) {
+                if (adjMatrix[cell][j] && values[j] >= 0 && values[j] < N) {
+                    available[values[j]] = false;
+                }
+            }
+            std::vector<cdcl::Lit> domain;
+            for (int color = 0; color < N; ++color) {
+                if (available[color]) {
+                    vars[cell][color] = sat.new_var();
+                    domain.push_back(cdcl::make_lit(vars[cell][color]));
+                }
+            }
+            // Exactly one color per cell
+            sat.add_clause(domain);
+            at_most_one(domain);
+        }
+
+        for (const auto& clique : find_cliques(adjMatrix)) {
+            if (this->stopped()) {
+                return;
+            }
+            for (int color = 0; color < N; ++color) {
+                std::vector<cdcl::Lit> lits;
+                bool given = false;
+                for (int cell : clique) {
+                    given = given || values[cell] == color;
+                    if (vars[cell][color] != -1) {
+                        lits.push_back(cdcl::make_lit(vars[cell][color]));
+                    }
+                }
+                at_most_one(lits);
+                // N mutually adjacent cells must use every color
+                if (static_cast<int>(clique.size()) == N && !given) {
+                    sat.add_clause(lits);
+                }
+            }
+        }
+    }
+
+public:
+    void solve(Board& board, const Matrix& adjMatrix) override {
+        // Cage sums have no CNF encoding here; let the backtracker handle them
+        if (this->cage_list && !this->cage_list->empty()) {
+            this->solve_with_backtracker(board, adjMatrix);
+            return;
+        }
+
+        std::array<int, SIZE> values;
+        for (int i = 0; i < SIZE; ++i) {
+            values[i] = board[i / N][i % N].value;
+        }
+
+        encode(values, adjMatrix);
+        std::size_t base_steps = this->steps;
+        cdcl::Result result = sat.solve([&] {
+            this->steps = base_steps + sat.get_decisions();  // Count each branching decision
+            return this->should_stop();
+        });
+        this->steps = base_steps + sat.get_decisions();
+        this->finish(result == cdcl::Result::Sat);
+
+        if (result == cdcl::Result::Unsat) {
+            std::cerr << "No solution exists for this puzzle.\n";
+            return;
+        }
+
+        // On a budget stop, keep the cells the search already proved
+        for (int cell = 0; cell < SIZE; ++cell) {
+            for (int color = 0; color < N; ++color) {
+                int var = vars[cell][color];
+                bool chosen = var != -1 && (result == cdcl::Result::Sat
+                                                ? sat.model_value(var)
+                                                : sat.fixed_value(var) > 0);
+                if (chosen) {
+                    board[cell / N][cell % N].value = color;
+                }
+            }
+        }
+    }
+};
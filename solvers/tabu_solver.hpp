@@ -0,0 +1,180 @@
+#pragma once
+
+#include "base_solver.hpp"
+#include "backtracking_solver.hpp"
+#include "dsatur_solver.hpp"
+#include <iostream>
+#include <random>
+#include <vector>
+
+// TabuCol local search seeded with the DSatur coloring. Where DSatur gives up
+// it leaves conflicts behind; the search repairs them by recoloring one
+// conflicting cell per iteration, forbidding moves back to a recently left
+// color for a while. Clues never move.
+template <int N>
+class TabuSolver : public BaseSolver<N> {
+    using typename BaseSolver<N>::Board;
+    using typename BaseSolver<N>::Matrix;
+    using BaseSolver<N>::SIZE;
+
+protected:
+    static constexpr std::size_t MAX_ITERATIONS = 1000 * SIZE;
+    static constexpr int TENURE_RANDOM = 10;
+    static constexpr double TENURE_FACTOR = 0.6;
+
+    std::array<std::vector<int>, SIZE> peers;
+    std::array<std::array<int, N>, SIZE> gamma;        // Neighbors of cell with color
+    std::array<std::array<std::size_t, N>, SIZE> tabu;  // Iteration a move is allowed again
+    std::array<bool, SIZE> fixed;
+    std::mt19937 rng{0};
+
+    static bool in_range(int color) { return color >= 0 && color < N; }
+
+    void recolor(std::array<int, SIZE>& colors, int cell, int color) {
+        for (int peer : peers[cell]) {
+            if (in_range(colors[cell])) {
+                gamma[peer][colors[cell]]--;
+            }
+            gamma[peer][color]++;
+        }
+        colors[cell] = color;
+    }
+
+    int least_conflicting_color(int cell) {
+        int best = 0;
+        for (int color = 1; color < N; ++color) {
+            if (gamma[cell][color] < gamma[cell][best]) {
+                best = color;
+            }
+        }
+        return best;
+    }
+
+    // Returns the remaining number of conflicting edges
+    int repair(std::array<int, SIZE>& colors) {
+        int conflicts = 0;
+        for (int cell = 0; cell < SIZE; ++cell) {
+            if (in_range(colors[cell])) {
+                conflicts += gamma[cell][colors[cell]];
+            }
+        }
+        conflicts /= 2;
+
+        std::array<int, SIZE> best_colors = colors;
+        int best_conflicts = conflicts;
+
+        for (std::size_t iter = 0; conflicts > 0 && iter < MAX_ITERATIONS; ++iter) {
+            if (this->should_stop()) {
+                break;
+            }
+            this->steps++;  // Count each local search move
+
+            int move_cell = -1, move_color = -1, move_delta = 0;
+            int candidates = 0, conflicting = 0;
+            for (int cell = 0; cell < SIZE; ++cell) {
+                int current = colors[cell];
+                if (fixed[cell] || gamma[cell][current] == 0) {
+                    continue;
+                }
+                conflicting++;
+                for (int color = 0; color < N; ++color) {
+                    if (color == current) {
+                        continue;
+                    }
+                    int delta = gamma[cell][color] - gamma[cell][current];
+                    // Aspiration: a tabu move is fine if it beats the best so far
+                    bool allowed = tabu[cell][color] <= iter ||
+                                   conflicts + delta < best_conflicts;
+                    if (!allowed) {
+                        continue;
+                    }
+                    if (move_cell == -1 || delta < move_delta) {
+                        move_cell = cell;
+                        move_color = color;
+                        move_delta = delta;
+                        candidates = 1;
+                    } else if (delta == move_delta &&
+                               std::uniform_int_distribution<int>(0, candidates++)(rng) == 0) {
+                        move_cell = cell;
+                        move_color = color;
+                    }
+                }
+            }
+            if (move_cell == -1) {
+                continue;  // Everything is tabu; wait for tenures to expire
+            }
+
+            int tenure = static_cast<int>(TENURE_FACTOR * conflicting) +
+                         std::uniform_int_distribution<int>(0, TENURE_RANDOM)(rng);
+            tabu[move_cell][colors[move_cell]] = iter + tenure;
+            recolor(colors, move_cell, move_color);
+            conflicts += move_delta;
+
+            if (conflicts < best_conflicts) {
+                best_conflicts = conflicts;
+                best_colors = colors;
+            }
+        }
+
+        colors = best_colors;
+        return best_conflicts;
+    }
+
+public:
+    void solve(Board& board, const Matrix& adjMatrix) override {
+        // Cage sums are not part of the conflict count; use the backtracker
+        if (this->cage_list && !this->cage_list->empty()) {
+            this->solve_with_backtracker(board, adjMatrix);
+            return;
+        }
+
+        Board seeded = board;
+        DSaturSolver<N> seed;
+        seed.set_stop_token(this->stop_token);
+        seed.set_budget(this->budget, this->budget_start);
+        seed.solve(seeded, adjMatrix);
+        this->steps += seed.get_steps();
+
+        for (int cell = 0; cell < SIZE; ++cell) {
+            peers[cell].clear();
+            for (int j = 0; j < SIZE; ++j) {
+                if (adjMatrix[cell][j]) {
+                    peers[cell].push_back(j);
+                }
+            }
+            gamma[cell].fill(0);
+            tabu[cell].fill(0);
+        }
+
+        // Clues are fixed; the repair never moves them
+        std::array<int, SIZE> colors;
+        for (int cell = 0; cell < SIZE; ++cell) {
+            int clue = board[cell / N][cell % N].value;
+            fixed[cell] = clue != -1;
+            colors[cell] = fixed[cell] ? clue : seeded[cell / N][cell % N].value;
+        }
+        for (int cell = 0; cell < SIZE; ++cell) {
+            if (in_range(colors[cell])) {
+                for (int peer : peers[cell]) {
+                    gamma[peer][colors[cell]]++;
+                }
+            }
+        }
+        // Cells the seed could not color take their least conflicting color
+        for (int cell = 0; cell < SIZE; ++cell) {
+            if (!in_range(colors[cell]) && !fixed[cell]) {
+                recolor(colors, cell, least_conflicting_color(cell));
+            }
+        }
+
+        int conflicts = repair(colors);
+        this->finish(conflicts == 0, false);
+        if (conflicts > 0 && !this->stopped()) {
+            std::cerr << "Tabu search left " << conflicts << " conflicts.\n";
+        }
+
+        for (int cell = 0; cell < SIZE; ++cell) {
+            board[cell / N][cell % N].value = colors[cell];
+        }
+    }
+};
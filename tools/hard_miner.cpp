@@ -0,0 +1,304 @@
+// Mines hard puzzles for one solver. Each climb starts from a random solution
+// grid stripped down to a minimal unique puzzle, then hill-climbs by dropping
+// or moving single clues, keeping a mutation when the puzzle stays unique and
+// the solver needs at least as many steps as before. The best puzzle of each
+// climb is appended to the output in the puzzle file format, after a comment
+// line with its score, so the corpus can grow across runs.
+//
+// Usage: hard_miner <solver_type> [options]
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "common/budget.hpp"
+#include "common/puzzle_io.hpp"
+#include "common/solution_counter.hpp"
+#include "common/sudoku_solver.hpp"
+
+namespace {
+
+struct MinerOptions {
+  int size = 9;
+  int workers = static_cast<int>(std::thread::hardware_concurrency());
+  std::size_t climbs = 8;  // Per worker; 0 runs until interrupted
+  std::size_t moves = 300;
+  std::size_t min_steps = 0;
+  unsigned seed = std::random_device{}();
+  std::string out_path;
+  SolveBudget budget{std::chrono::milliseconds(0), 1000000, 0};
+};
+
+struct Score {
+  std::size_t steps;
+  SolveStatus status;
+};
+
+void print_usage(const char* program_name) {
+  std::cout
+      << "Usage: " << program_name << " <solver_type> [options]\n"
+      << "Options:\n"
+      << "  --size <4|9|16> - Board size (default 9)\n"
+      << "  --workers <n> - Mining threads (default: one per CPU)\n"
+      << "  --climbs <n> - Climbs per worker, 0 for no limit (default 8)\n"
+      << "  --moves <n> - Mutations tried per climb (default 300)\n"
+      << "  --max-nodes <n> - Step cap for one evaluation (default 1000000)\n"
+      << "  --time-ms <ms> - Time cap for one evaluation\n"
+      << "  --min-steps <n> - Only save puzzles at least this hard\n"
+      << "  --seed <n> - Random seed\n"
+      << "  --out <file> - Append puzzles here instead of stdout\n";
+}
+
+template <int N, SolverType Type>
+Score score_as(const std::array<std::array<Square, N>, N>& board,
+               const SolveBudget& budget) {
+  auto solver = std::make_unique<SudokuSolver<N, Type>>(board);
+  solver->budget = budget;
+  solver->solve();
+  return {solver->get_steps(), solver->get_status()};
+}
+
+template <int N>
+using Scorer = std::function<Score(const std::array<std::array<Square, N>, N>&)>;
+
+template <int N>
+Scorer<N> make_scorer(SolverType type, const SolveBudget& budget) {
+  switch (type) {
+    case SolverType::Greedy:
+      return [=](const auto& b) { return score_as<N, SolverType::Greedy>(b, budget); };
+    case SolverType::DSatur:
+      return [=](const auto& b) { return score_as<N, SolverType::DSatur>(b, budget); };
+    case SolverType::Backtracking:
+      return [=](const auto& b) {
+        return score_as<N, SolverType::Backtracking>(b, budget);
+      };
+    case SolverType::RandomizedBacktracking:
+      return [=](const auto& b) {
+        return score_as<N, SolverType::RandomizedBacktracking>(b, budget);
+      };
+    case SolverType::HeuristicKempe:
+      return [=](const auto& b) {
+        return score_as<N, SolverType::HeuristicKempe>(b, budget);
+      };
+    case SolverType::Sat:
+      return [=](const auto& b) { return score_as<N, SolverType::Sat>(b, budget); };
+    case SolverType::Tabu:
+      return [=](const auto& b) { return score_as<N, SolverType::Tabu>(b, budget); };
+    case SolverType::Portfolio:
+      return [=](const auto& b) {
+        return score_as<N, SolverType::Portfolio>(b, budget);
+      };
+  }
+  throw std::invalid_argument("Invalid solver type");
+}
+
+// Collects the climb results; duplicates and easy puzzles are dropped
+class Corpus {
+ public:
+  Corpus(std::ostream& out, std::string solver_name, std::size_t min_steps)
+      : out_(out), solver_name_(std::move(solver_name)), min_steps_(min_steps) {}
+
+  void remember(const std::string& line) { seen_.insert(line); }
+
+  void submit(const std::string& line, const Score& score) {
+    std::lock_guard lock(mutex_);
+    if (score.steps < min_steps_ || !seen_.insert(line).second) return;
+    out_ << "# " << solver_name_ << ": " << score.steps << " steps, "
+         << to_string(score.status) << "\n"
+         << line << "\n";
+    out_.flush();
+    saved_++;
+    std::clog << "Saved puzzle " << saved_ << " (" << score.steps
+              << " steps)\n";
+  }
+
+  std::size_t saved() const { return saved_; }
+
+ private:
+  std::mutex mutex_;
+  std::ostream& out_;
+  std::string solver_name_;
+  std::size_t min_steps_;
+  std::unordered_set<std::string> seen_;
+  std::size_t saved_ = 0;
+};
+
+template <int N>
+class Miner {
+ public:
+  static constexpr int SIZE = N * N;
+  // A uniqueness check that needs more nodes counts as not unique
+  static constexpr std::size_t COUNT_NODES = 100000;
+  using Board = std::array<std::array<Square, N>, N>;
+
+  Miner(const MinerOptions& options, Scorer<N> scorer, unsigned seed)
+      : options_(options), scorer_(std::move(scorer)), rng_(seed) {}
+
+  void climb(Corpus& corpus) {
+    Board grid;
+    for (int cell = 0; cell < SIZE; ++cell) grid[cell / N][cell % N] = {cell, -1};
+    counter_.complete(grid, rng_);
+
+    // Strip clues in random order while the solution stays unique
+    Board puzzle = grid;
+    std::vector<int> cells(SIZE);
+    std::iota(cells.begin(), cells.end(), 0);
+    std::shuffle(cells.begin(), cells.end(), rng_);
+    for (int cell : cells) {
+      int value = at(puzzle, cell);
+      at(puzzle, cell) = -1;
+      if (!unique(puzzle)) at(puzzle, cell) = value;
+    }
+
+    Score best = scorer_(puzzle);
+    for (std::size_t move = 0; move < options_.moves; ++move) {
+      Board candidate = puzzle;
+      mutate(candidate, grid);
+      if (!unique(candidate)) continue;
+      Score score = scorer_(candidate);
+      // Equal scores are accepted so the climb can cross plateaus
+      if (score.steps >= best.steps) {
+        puzzle = candidate;
+        best = score;
+      }
+    }
+    corpus.submit(format_board<N>(puzzle), best);
+  }
+
+ private:
+  const MinerOptions& options_;
+  Scorer<N> scorer_;
+  SolutionCounter<N> counter_;
+  std::mt19937 rng_;
+
+  static int& at(Board& board, int cell) { return board[cell / N][cell % N].value; }
+
+  bool unique(const Board& puzzle) {
+    return counter_.count(puzzle, 2, COUNT_NODES) == 1 && !counter_.aborted();
+  }
+
+  // Drops a random clue, and usually puts one back on a random empty cell
+  void mutate(Board& puzzle, const Board& grid) {
+    std::vector<int> clues, empty;
+    for (int cell = 0; cell < SIZE; ++cell) {
+      (at(puzzle, cell) == -1 ? empty : clues).push_back(cell);
+    }
+    if (clues.empty()) return;
+    at(puzzle, clues[rng_() % clues.size()]) = -1;
+    if (!empty.empty() && rng_() % 4 != 0) {
+      int cell = empty[rng_() % empty.size()];
+      at(puzzle, cell) = grid[cell / N][cell % N].value;
+    }
+  }
+};
+
+template <int N>
+std::size_t mine(SolverType type, const MinerOptions& options, Corpus& corpus) {
+  Scorer<N> scorer = make_scorer<N>(type, options.budget);
+  std::vector<std::jthread> workers;
+  for (int w = 0; w < std::max(options.workers, 1); ++w) {
+    workers.emplace_back([&, w] {
+      Miner<N> miner(options, scorer, options.seed + w);
+      for (std::size_t i = 0; options.climbs == 0 || i < options.climbs; ++i) {
+        miner.climb(corpus);
+      }
+    });
+  }
+  workers.clear();  // Joins
+  return corpus.saved();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  SolverType type = SolverType::Backtracking;
+  MinerOptions options;
+  try {
+    type = parse_solver_type(argv[1]);
+    for (int i = 2; i < argc; ++i) {
+      std::string arg = argv[i];
+      if (i + 1 >= argc) throw std::invalid_argument("Missing value for " + arg);
+      std::string value = argv[++i];
+      if (arg == "--size") {
+        options.size = std::stoi(value);
+      } else if (arg == "--workers") {
+        options.workers = std::stoi(value);
+      } else if (arg == "--climbs") {
+        options.climbs = std::stoul(value);
+      } else if (arg == "--moves") {
+        options.moves = std::stoul(value);
+      } else if (arg == "--max-nodes") {
+        options.budget.nodes = std::stoul(value);
+      } else if (arg == "--time-ms") {
+        options.budget.time = std::chrono::milliseconds(std::stoul(value));
+      } else if (arg == "--min-steps") {
+        options.min_steps = std::stoul(value);
+      } else if (arg == "--seed") {
+        options.seed = static_cast<unsigned>(std::stoul(value));
+      } else if (arg == "--out") {
+        options.out_path = value;
+      } else {
+        throw std::invalid_argument("Unknown option " + arg);
+      }
+    }
+  } catch (const std::exception& e) {
+    std::cerr << "Error: " << e.what() << "\n";
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  std::ofstream out_file;
+  std::unique_ptr<Corpus> corpus;
+  std::string solver_name = solver_type_to_string(type);
+  if (options.out_path.empty()) {
+    corpus = std::make_unique<Corpus>(std::cout, solver_name, options.min_steps);
+  } else {
+    // Puzzles already in the file are not saved twice
+    std::ifstream existing(options.out_path);
+    out_file.open(options.out_path, std::ios::app);
+    if (!out_file) {
+      std::cerr << "Cannot open " << options.out_path << "\n";
+      return 1;
+    }
+    corpus = std::make_unique<Corpus>(out_file, solver_name, options.min_steps);
+    for (std::string line; std::getline(existing, line);) {
+      if (is_board_line(line)) corpus->remember(line);
+    }
+  }
+
+  // Failed evaluations are routine here; keep the solvers' diagnostics quiet
+  std::cerr.rdbuf(nullptr);
+
+  std::size_t saved;
+  switch (options.size) {
+    case 4:
+      saved = mine<4>(type, options, *corpus);
+      break;
+    case 9:
+      saved = mine<9>(type, options, *corpus);
+      break;
+    case 16:
+      saved = mine<16>(type, options, *corpus);
+      break;
+    default:
+      std::clog << "Board size must be 4, 9 or 16\n";
+      return 1;
+  }
+  std::clog << "Saved " << saved << " puzzles\n";
+  return 0;
+}